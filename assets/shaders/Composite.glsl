@@ -0,0 +1,34 @@
+// Composite Shader
+// Draws a cached framebuffer as one quad in world space
+
+#type vertex
+#version 330 core
+
+layout(location = 0) in vec2 a_Corner;
+
+uniform mat4 u_ViewProjection;
+uniform vec2 u_Origin;
+uniform vec2 u_Size;
+uniform float u_Depth;
+
+out vec2 v_TexCoord;
+
+void main()
+{
+	v_TexCoord = a_Corner + 0.5;
+	gl_Position = u_ViewProjection * vec4(u_Origin + a_Corner * u_Size, u_Depth, 1.0);
+}
+
+#type fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	color = texture(u_Texture, v_TexCoord);
+}
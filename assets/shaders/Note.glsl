@@ -0,0 +1,43 @@
+// Note Shader
+// Notes are uploaded once per chart, scrolling only changes uniforms
+
+#type vertex
+#version 330 core
+
+layout(location = 0) in float a_Time;
+layout(location = 1) in vec2 a_Corner;
+layout(location = 2) in float a_Lane;
+
+uniform mat4 u_ViewProjection;
+uniform float u_Velocity;
+uniform float u_Offset;
+uniform float u_Depth;
+// x centre, width, height per lane
+uniform vec3 u_Lanes[16];
+
+out vec2 v_TexCoord;
+
+void main()
+{
+	vec3 lane = u_Lanes[int(a_Lane)];
+	vec2 position = vec2(
+		lane.x + a_Corner.x * lane.y,
+		a_Time * u_Velocity + u_Offset + a_Corner.y * lane.z);
+	v_TexCoord = a_Corner + 0.5;
+	gl_Position = u_ViewProjection * vec4(position, u_Depth, 1.0);
+}
+
+#type fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+uniform vec4 u_Tint;
+
+void main()
+{
+	color = texture(u_Texture, v_TexCoord) * u_Tint;
+}
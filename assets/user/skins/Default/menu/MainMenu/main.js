@@ -70,7 +70,12 @@ function applySettings() {
             "PAUSE"       : PAUSE.value
         },
         "Audio" : {
-            "Volume" : Volume.valueAsNumber
+            "Volume" : Volume.valueAsNumber,
+            "LowLatency" : Number(LowLatency.value),
+            "BufferLength" : BufferLength.valueAsNumber,
+            "BufferCount" : BufferCount.valueAsNumber,
+            "AudioOffset" : AudioOffset.valueAsNumber,
+            "InputOffset" : InputOffset.valueAsNumber
         },
         "Game" : {
             "CameraVelocity" : CameraVelocity.valueAsNumber,
@@ -78,6 +83,16 @@ function applySettings() {
             "ThresholdMultiple" : ThresholdMultiple.valueAsNumber,
             "MeanWindow" : MeanWindow.valueAsNumber,
             "MaximaWindow" : MaximaWindow.valueAsNumber,
+            "GridDivision" : GridDivision.valueAsNumber,
+            "DetectionMode" : Number(DetectionMode.value),
+            "Percussive" : Number(Percussive.value),
+            "Bands" : Bands.valueAsNumber,
+            "Difficulty" : Number(Difficulty.value),
+            "PerfectWindow" : PerfectWindow.valueAsNumber,
+            "GoodWindow" : GoodWindow.valueAsNumber,
+            "MissWindow" : MissWindow.valueAsNumber,
+            "LibraryCores" : LibraryCores.valueAsNumber,
+            "MusicFolders" : MusicFolders.value,
             "Skin" : Skin.value
         }
     };
@@ -158,6 +173,96 @@ function inputToUpper(event) {
     this.value = event.data.toUpperCase();
 }
 
+//Song library list, only rows on screen exist in the DOM and only they are fetched from C
+const SONG_ROW_HEIGHT = 56;
+const SONG_OVERSCAN = 8;
+var songQuery = { sort: 0, descending: false, filter: "" };
+var songPage = { offset: 0, total: 0, version: -1, rows: [] };
+var songRows = [];
+var songFrame = 0;
+var songScanning = false;
+
+function formatLength(seconds) {
+    let minutes = Math.floor(seconds / 60);
+    let rest = Math.floor(seconds % 60);
+    return minutes + ":" + (rest < 10 ? "0" : "") + rest;
+}
+
+function createSongRow() {
+    let row = document.createElement("div");
+    row.className = "song";
+    for (let i = 0; i < 3; i++) {
+        row.appendChild(document.createElement("span"));
+    }
+    //Shift plays the rest of the song's folder after it
+    row.addEventListener("click", (event) => PlaySong(row.path, event.shiftKey));
+    SongList.appendChild(row);
+    return row;
+}
+
+function renderSongs(refetch) {
+    songFrame = 0;
+    let visible = Math.ceil(SongList.clientHeight / SONG_ROW_HEIGHT) + SONG_OVERSCAN * 2;
+    let first = Math.max(Math.floor(SongList.scrollTop / SONG_ROW_HEIGHT) - SONG_OVERSCAN, 0);
+
+    //Only ask again once the view leaves the page already held
+    let held = songPage.offset + songPage.rows.length;
+    if (refetch || first < songPage.offset || Math.min(first + visible, songPage.total) > held) {
+        let page = QuerySongs(Math.max(first - visible, 0), visible * 3,
+            songQuery.sort, songQuery.descending, songQuery.filter);
+        if (page) {
+            songPage = page;
+        }
+    }
+
+    SongSpacer.style.height = (songPage.total * SONG_ROW_HEIGHT) + "px";
+    SongStatus.textContent = songPage.total + " songs" + (songScanning ? " (scanning...)" : "");
+
+    //Row elements are reused, there are only ever as many as fit on screen
+    while (songRows.length < visible) {
+        songRows.push(createSongRow());
+    }
+    let last = Math.min(first + visible, songPage.offset + songPage.rows.length);
+    for (let i = 0; i < songRows.length; i++) {
+        let row = songRows[i];
+        let index = first + i;
+        if (index >= last) {
+            row.style.display = "none";
+            continue;
+        }
+
+        let song = songPage.rows[index - songPage.offset];
+        row.style.display = "grid";
+        row.style.top = (index * SONG_ROW_HEIGHT) + "px";
+        row.path = song[0];
+        row.children[0].textContent = song[1];
+        row.children[1].textContent = song[2];
+        row.children[2].textContent = formatLength(song[4]);
+    }
+}
+
+function scheduleSongs() {
+    if (!songFrame) {
+        songFrame = requestAnimationFrame(() => renderSongs(false));
+    }
+}
+
+function pollLibrary() {
+    if (Library.style.display != "block") {
+        return;
+    }
+    let state = GetLibraryState();
+    if (state.version != songPage.version || state.scanning != songScanning) {
+        songScanning = state.scanning;
+        renderSongs(true);
+    }
+}
+
+function resetSongs() {
+    SongList.scrollTop = 0;
+    renderSongs(true);
+}
+
 
 //Event listeners
 MenuSettings.addEventListener("click", () => display(Settings,
@@ -179,6 +284,35 @@ GameHeader.addEventListener("click", () => display(
 SettingsQuit.addEventListener("click", () => display(MainMenu,
  document.body.children, "block"));
 
+MenuLibrary.addEventListener("click", () => {
+    display(Library, document.body.children, "block");
+    renderSongs(true);
+});
+
+LibraryQuit.addEventListener("click", () => display(MainMenu,
+ document.body.children, "block"));
+
+SongList.addEventListener("scroll", scheduleSongs);
+window.addEventListener("resize", scheduleSongs);
+
+SongFilter.addEventListener("input", function() {
+    songQuery.filter = this.value;
+    resetSongs();
+});
+
+SongSort.onchange = function() {
+    songQuery.sort = Number(this.value);
+    resetSongs();
+}
+
+SongOrder.addEventListener("click", function() {
+    songQuery.descending = !songQuery.descending;
+    this.innerHTML = songQuery.descending ? "&#9660;" : "&#9650;";
+    resetSongs();
+});
+
+setInterval(pollLibrary, 1000);
+
 VolumeSelect.onchange = function() {
     Volume.value = this.value;
 }
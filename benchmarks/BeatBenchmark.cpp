@@ -0,0 +1,191 @@
+#include <OnBeat/App/MusicLayer/NoteRenderer/NoteRenderer.h>
+#include <OnBeat/Config/DrawCommand.h>
+#include <Hazel/Renderer/Renderer2D.h>
+#include <Support/HeadlessGL.h>
+#include <benchmark/benchmark.h>
+#include <variant>
+#include <vector>
+
+//Per frame cost of drawing a colour only beat skin, before and after the resolved draw commands and the note buffer
+//DrawCommand and NoteRenderer are the game's own, the engine's renderer is the stand-in in tests/include
+
+using namespace OnBeat;
+
+namespace
+{
+	//Headless context with the batch renderer up, world space is [-2, 2] on both axes
+	class BeatFrame
+	{
+		public:
+			BeatFrame()
+				: GL(128, 128), Camera(-2.0f, 2.0f, -2.0f, 2.0f)
+			{
+				if (GL.IsValid())
+					Hazel::Renderer2D::Init();
+			}
+
+			~BeatFrame()
+			{
+				if (GL.IsValid())
+					Hazel::Renderer2D::Shutdown();
+			}
+
+			void Clear()
+			{
+				glClear(GL_COLOR_BUFFER_BIT);
+			}
+
+			Test::HeadlessGL GL;
+			Hazel::OrthographicCamera Camera;
+	};
+
+	const Skin::ColourTexture Red = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+
+	Chart CreateChart(int notes)
+	{
+		//Every note on screen, the worst case for a per beat loop
+		Chart chart(4);
+		for (int n = 0; n < notes; n++)
+		{
+			chart.Add(n % 4, (int64_t)n * 2000 / notes);
+		}
+		chart.Finalise();
+		return chart;
+	}
+
+	//The old CreateBeats, std::get inside try/catch picks texture or colour for every beat
+	void SubmitThrowing(const Chart& chart, const Skin::ColourTexture& colour)
+	{
+		float z = 0.01f;
+		for (int c = 0; c < chart.GetColumnCount(); c++)
+		{
+			for (int64_t sample : chart.GetColumn(c))
+			{
+				glm::vec3 position = { -1.5f + c, sample / 1000.0f - 1.0f, z };
+				try
+				{
+					Hazel::Renderer2D::DrawQuad(position, { 0.8f, 0.2f }, std::get<Hazel::Ref<Hazel::Texture2D>>(colour));
+				}
+				catch (std::bad_variant_access const&)
+				{
+					Hazel::Renderer2D::DrawQuad(position, { 0.8f, 0.2f }, std::get<glm::vec4>(colour));
+				}
+				z += 0.001f;
+			}
+		}
+	}
+
+	//CreateBeats once the skin resolved its DrawCommand, a null check per beat
+	void SubmitResolved(const Chart& chart, const Skin::DrawCommand& command)
+	{
+		float z = 0.01f;
+		for (int c = 0; c < chart.GetColumnCount(); c++)
+		{
+			for (int64_t sample : chart.GetColumn(c))
+			{
+				command.Draw({ -1.5f + c, sample / 1000.0f - 1.0f, z }, { 0.8f, 0.2f });
+				z += 0.001f;
+			}
+		}
+	}
+}
+
+//Submission alone, the batch is restarted each iteration and never drawn
+static void BM_SubmitBeats_Throwing(benchmark::State& state)
+{
+	BeatFrame frame;
+	if (!frame.GL.IsValid())
+	{
+		state.SkipWithError("No headless GL driver");
+		return;
+	}
+	Chart chart = CreateChart((int)state.range(0));
+	for (auto _ : state)
+	{
+		Hazel::Renderer2D::BeginScene(frame.Camera);
+		SubmitThrowing(chart, Red);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SubmitBeats_Throwing)->Arg(250)->Arg(1000)->Arg(4000);
+
+static void BM_SubmitBeats_Resolved(benchmark::State& state)
+{
+	BeatFrame frame;
+	if (!frame.GL.IsValid())
+	{
+		state.SkipWithError("No headless GL driver");
+		return;
+	}
+	Chart chart = CreateChart((int)state.range(0));
+	Skin::DrawCommand command(Red);
+	for (auto _ : state)
+	{
+		Hazel::Renderer2D::BeginScene(frame.Camera);
+		SubmitResolved(chart, command);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SubmitBeats_Resolved)->Arg(250)->Arg(1000)->Arg(4000);
+
+//Before, every beat is thrown through the variant, batched on the CPU and streamed to the GPU each frame
+static void BM_BeatFrame_Batched(benchmark::State& state)
+{
+	BeatFrame frame;
+	if (!frame.GL.IsValid())
+	{
+		state.SkipWithError("No headless GL driver");
+		return;
+	}
+	Chart chart = CreateChart((int)state.range(0));
+	//The driver compiles the shader on first use
+	Hazel::Renderer2D::BeginScene(frame.Camera);
+	SubmitThrowing(chart, Red);
+	Hazel::Renderer2D::EndScene();
+	frame.GL.Finish();
+
+	for (auto _ : state)
+	{
+		frame.Clear();
+		Hazel::Renderer2D::BeginScene(frame.Camera);
+		SubmitThrowing(chart, Red);
+		Hazel::Renderer2D::EndScene();
+		frame.GL.Finish();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BeatFrame_Batched)->Arg(250)->Arg(1000)->Arg(4000)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+//After, the chart is uploaded once and a frame only sets the scroll uniforms
+static void BM_BeatFrame_NoteRenderer(benchmark::State& state)
+{
+	BeatFrame frame;
+	if (!frame.GL.IsValid())
+	{
+		state.SkipWithError("No headless GL driver");
+		return;
+	}
+	Chart chart = CreateChart((int)state.range(0));
+	std::vector<Skin::MusicSkin::Lane> lanes(4);
+	for (int l = 0; l < 4; l++)
+	{
+		lanes[l].X = -1.5f + l;
+		lanes[l].BeatSize = { 0.8f, 0.2f };
+	}
+
+	NoteRenderer notes;
+	notes.Upload(chart, 1000.0);
+	notes.SetLanes(lanes);
+	notes.SetBeat(Skin::DrawCommand(Red));
+	notes.Draw(frame.Camera, 1.0f, -1.0f);
+	frame.GL.Finish();
+
+	for (auto _ : state)
+	{
+		frame.Clear();
+		notes.Draw(frame.Camera, 1.0f, -1.0f);
+		frame.GL.Finish();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BeatFrame_NoteRenderer)->Arg(250)->Arg(1000)->Arg(4000)->UseRealTime()->Unit(benchmark::kMicrosecond);
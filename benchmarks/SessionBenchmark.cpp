@@ -0,0 +1,45 @@
+#include <OnBeat/App/MusicLayer/Chart/Chart.h>
+#include <benchmark/benchmark.h>
+#include <array>
+
+//Main thread cost of replaying a cached song, MusicLayer::Restore copies every difficulty's chart out of the session
+//The sound rewind is queued to the audio thread so it is not part of the frame, the game logs when it is ready
+
+using namespace OnBeat;
+
+namespace
+{
+	//DifficultyDensity in notes per second, OnSetDetection needs the analysis libraries so it is mirrored here
+	const std::array<double, 4> Density = { 2.0, 4.0, 7.0, 12.0 };
+
+	std::array<Chart, 4> MakeCharts(double seconds, int rate = 44100)
+	{
+		std::array<Chart, 4> charts;
+		for (size_t d = 0; d < charts.size(); d++)
+		{
+			size_t notes = (size_t)(seconds * Density[d]);
+			for (size_t n = 0; n < notes; n++)
+			{
+				charts[d].Add((int)(n % 4), (int64_t)(n * rate / Density[d]));
+			}
+			charts[d].Finalise();
+		}
+		return charts;
+	}
+}
+
+static void BM_RestoreCharts(benchmark::State& state)
+{
+	const std::array<Chart, 4> session = MakeCharts((double)state.range(0));
+	for (auto _ : state)
+	{
+		//A new layer each time so the copy allocates as it does in game
+		std::array<Chart, 4> layer = session;
+		benchmark::DoNotOptimize(layer);
+		benchmark::ClobberMemory();
+	}
+	state.counters["Notes"] = (double)(session[0].GetNoteCount() + session[1].GetNoteCount() +
+		session[2].GetNoteCount() + session[3].GetNoteCount());
+}
+//Song length in seconds
+BENCHMARK(BM_RestoreCharts)->Arg(180)->Arg(600)->Arg(1800)->Unit(benchmark::kMicrosecond);
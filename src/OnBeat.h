@@ -4,7 +4,15 @@
 
 #include "OnBeat/App/App.h"
 #include "OnBeat/App/MusicLayer/MusicLayer.h"
+#include "OnBeat/App/MusicLayer/Chart/Chart.h"
+#include "OnBeat/App/MusicLayer/NoteRenderer/NoteRenderer.h"
+#include "OnBeat/App/MusicLayer/PlayfieldCache/PlayfieldCache.h"
+#include "OnBeat/App/MusicLayer/SessionCache/SessionCache.h"
+#include "OnBeat/App/MusicLayer/Judgement/Judgement.h"
+#include "OnBeat/App/MusicLayer/Simulation/Simulation.h"
+#include "OnBeat/App/Playlist/Playlist.h"
 #include "OnBeat/App/LayerStack/LayerStack.h"
+#include "OnBeat/App/CalibrationLayer/CalibrationLayer.h"
 
 #include "OnBeat/Config/Config.h"
 #include "OnBeat/Config/Skin.h"
@@ -1,5 +1,5 @@
 #include <OnBeat/App/App.h>
-#include <Hazel/Core/EntryPoint.h>
+#include <Hazel/ImGui/ImGuiLayer.h>
 #include <glfw/glfw3.h>
 #include <stb_image/stb_image.h>
 #include <imgui.h>
@@ -9,8 +9,8 @@ namespace OnBeat
 
 	App* App::instance = nullptr;
 
-	App::App()
-		: Application("OnBeat")
+	App::App(AudioOutput output, const std::string& outputFile)
+		: Application("OnBeat"), AudioPlayer("", output, outputFile)
 	{
 		instance = this;
 	
@@ -18,6 +18,8 @@ namespace OnBeat
 		auto& window = Hazel::Application::Get().GetWindow();
 		NativeWindow = static_cast<GLFWwindow*>(window.GetNativeWindow());
 		SetWindowIcon("logo/logo-64.png");
+		Input::Get().Attach(NativeWindow);
+		Sessions.SetEvictCallback([this](const std::string& file) { AudioPlayer.EvictSound(file); });
 
 		//Settings initialisation
 		Settings = Config::Settings::Create(OB_SETTINGS);
@@ -31,19 +33,124 @@ namespace OnBeat
 		//Setup layers
 		PushLayer(LayerStack);
 
-		MainMenu = new OnBeat::MainMenu(Settings.Game.Skin.SkinDirectory + OB_MAIN_MENU, "Main Menu");
-		LayerStack->AttachLayer(MainMenu);
+		OpenMainMenu();
 	}
 
 	void App::StartGame(const std::string& song)
 	{
-		LayerStack->PopLayer(MainMenu);
-		MainMenu = nullptr;
+		if (MainMenu)
+		{
+			LayerStack->PopLayer(MainMenu);
+			MainMenu = nullptr;
+		}
+
+		//Gameplay gets the whole machine back, the library picks up where it stopped afterwards
+		LibraryScheduler::Get().Pause();
 
 		glfwSetCursor(NativeWindow, nullptr);
-		//TODO(Callum): Get these from settings
-		MusicLayer = new OnBeat::MusicLayer(song, Settings.Game.CameraVelocity, 44100, 512);
+		double sampleRate = OB_ANALYSIS_SAMPLE_RATE;
+		int sampleSize = OB_ANALYSIS_FRAME_SIZE;
+		MusicLayer = new OnBeat::MusicLayer(song, Settings.Game.CameraVelocity, sampleRate, sampleSize);
 		LayerStack->AttachLayer(MusicLayer);
+
+		//Runs alongside this song's loading on its own thread, throttled to a share of one core
+		if (Playlist.HasNext())
+			Playlist.PreloadNext(MusicLayer->GetOptions(), MusicLayer->GetColumnCount(), sampleRate, sampleSize);
+	}
+
+	void App::StartPlaylist(const std::string& first)
+	{
+		Playlist.Set(OnBeat::Playlist::FromFolder(first));
+		StartGame(Playlist.GetCurrent());
+	}
+
+	void App::NextSong()
+	{
+		if (!Playlist.Advance())
+		{
+			EndGame();
+			return;
+		}
+		CloseGame();
+		StartGame(Playlist.GetCurrent());
+	}
+
+	void App::EndGame()
+	{
+		Playlist.Clear();
+		CloseGame();
+		OpenMainMenu();
+		LibraryScheduler::Get().Resume();
+	}
+
+	void App::CloseGame()
+	{
+		//Songs still in the session cache keep their decoded sound for a replay
+		bool resident = Sessions.Contains(MusicLayer->GetSessionKey());
+		LayerStack->PopLayer(MusicLayer);
+		delete MusicLayer;
+		MusicLayer = nullptr;
+		AudioPlayer.ReleaseSound(resident);
+	}
+
+	void App::StartCalibration()
+	{
+		LayerStack->PopLayer(MainMenu);
+		MainMenu = nullptr;
+		//Tapping needs steady frames as much as gameplay does
+		LibraryScheduler::Get().Pause();
+
+		CalibrationLayer = new OnBeat::CalibrationLayer();
+		LayerStack->AttachLayer(CalibrationLayer);
+	}
+
+	void App::EndCalibration()
+	{
+		LayerStack->PopLayer(CalibrationLayer);
+		delete CalibrationLayer;
+		CalibrationLayer = nullptr;
+
+		OpenMainMenu();
+		LibraryScheduler::Get().Resume();
+	}
+
+	void App::OpenMainMenu()
+	{
+		//Picks up songs added while playing where there is no filesystem watcher
+		SongLibrary::Get().Refresh();
+		MainMenu = new OnBeat::MainMenu(Settings.Game.Skin.SkinDirectory + OB_MAIN_MENU, "Main Menu");
+		LayerStack->AttachLayer(MainMenu);
+	}
+
+	void App::Run()
+	{
+		//Owns the loop rather than Hazel so pacing and the extra poll happen before any layer updates
+		while (Running)
+		{
+			//Wait out the frame cap first then poll again so the frame uses the freshest input
+			Pacer.Wait();
+			if (Pacer.GetCap())
+			{
+				glfwPollEvents();
+			}
+			if (!Running || glfwWindowShouldClose(NativeWindow))
+				break;
+
+			float time = (float)glfwGetTime();
+			Hazel::Timestep ts = time - LastFrameTime;
+			LastFrameTime = time;
+
+			if (!glfwGetWindowAttrib(NativeWindow, GLFW_ICONIFIED))
+			{
+				LayerStack->OnUpdate(ts);
+			}
+			GetImGuiLayer()->Begin();
+			LayerStack->OnImGuiRender();
+			GetImGuiLayer()->End();
+			Pacer.EndFrame();
+
+			GetWindow().OnUpdate();
+		}
 	}
 
 	void App::RefreshSettings()
@@ -55,7 +162,22 @@ namespace OnBeat
 		}
 		SetFullScreen(Settings.Video.Fullscreen);
 		glfwSwapInterval(Settings.Video.VSync);
+		Pacer.SetCap(Settings.Video.FpsCap);
 		AudioPlayer.SetVolume(Settings.Audio.Volume);
+		AudioPlayer.SetOutput(Settings.Audio.LowLatency ? Settings.Audio.BufferLength : 0, Settings.Audio.BufferCount);
+		auto& hitsounds = Settings.Game.Skin.MusicSkin.Hitsounds;
+		AudioPlayer.SetHitsounds({ hitsounds.Hit, hitsounds.Miss }, hitsounds.Volume);
+		auto folders = Util::splitString(Settings.Game.MusicFolders, ';');
+		SongLibrary::Get().Configure(folders);
+		LibraryScheduler::Get().Configure(folders, OnBeat::MusicLayer::CreateOnSetOptions(Settings.Game),
+			OB_ANALYSIS_FRAME_SIZE, OB_ANALYSIS_SAMPLE_RATE, Settings.Game.LibraryCores);
+
+		//Charts for every difficulty are already cached on the layer
+		if (MusicLayer)
+		{
+			MusicLayer->SetDifficulty((Difficulty)Settings.Game.Difficulty);
+			MusicLayer->RefreshInput(Settings);
+		}
 	}
 
 	int App::SetSettings(const Config::Settings& newS)
@@ -123,13 +245,41 @@ namespace OnBeat
 
 	App::~App()
 	{
+		//Joins the preload thread before the audio player and session cache it hands over to are gone
+		Playlist.Clear();
+		Input::Get().Detach();
+		//Library first, the scheduler waits on its scan
+		SongLibrary::Get().Stop();
+		LibraryScheduler::Get().Stop();
 	}
 }
 
-Hazel::Application* Hazel::CreateApplication()
+int main(int argc, char** argv)
 {
 #ifdef DIST
 	FreeConsole();
 #endif
-	return new OnBeat::App();
+	Hazel::Log::Init();
+
+	//--nosound or --wav <file> render without an audio device
+	OnBeat::AudioOutput output = OnBeat::AudioOutput::Device;
+	std::string outputFile;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--nosound")
+		{
+			output = OnBeat::AudioOutput::NoSound;
+		}
+		else if (arg == "--wav" && i + 1 < argc)
+		{
+			output = OnBeat::AudioOutput::WavWriter;
+			outputFile = argv[++i];
+		}
+	}
+
+	auto app = new OnBeat::App(output, outputFile);
+	app->Run();
+	delete app;
+	return 0;
 }
\ No newline at end of file
@@ -1,9 +1,17 @@
 #pragma once
 #include <OnBeat/Config/Config.h>
 #include <OnBeat/App/LayerStack/LayerStack.h>
+#include <OnBeat/App/CalibrationLayer/CalibrationLayer.h>
 #include <OnBeat/App/MusicLayer/MusicLayer.h>
+#include <OnBeat/App/MusicLayer/SessionCache/SessionCache.h>
+#include <OnBeat/App/Playlist/Playlist.h>
 #include <OnBeat/Ui/MainMenu/MainMenu.h>
+#include <OnBeat/Util/AppUtil/AppUtil.h>
 #include <OnBeat/Util/AudioPlayer/AudioPlayer.h>
+#include <OnBeat/Util/FramePacer/FramePacer.h>
+#include <OnBeat/Util/LibraryScheduler/LibraryScheduler.h>
+#include <OnBeat/Util/SongLibrary/SongLibrary.h>
+#include <OnBeat/Util/Input/Input.h>
 #include <Hazel/Core/Application.h>
 
 typedef struct GLFWwindow GLFWwindow;
@@ -14,10 +22,22 @@ namespace OnBeat
 	{
 
 		public:
-			App();
+			//Headless outputs mix as fast as frames are drawn and gameplay follows the mixed audio
+			App(AudioOutput output = AudioOutput::Device, const std::string& outputFile = "");
 			~App();
 
 			void StartGame(const std::string& song);
+			//Plays the chosen song then the rest of its folder
+			void StartPlaylist(const std::string& first);
+			//Next playlist song straight from the session cache, or back to the menu at the end
+			void NextSong();
+			void EndGame();
+			void StartCalibration();
+			void EndCalibration();
+
+			//Paces, polls, updates then presents a frame until the window closes
+			void Run();
+			void Close() { Running = false; }
 
 			void RefreshSettings();
 			int SetSettings(const Config::Settings& newS);
@@ -26,23 +46,35 @@ namespace OnBeat
 			static App& Get() { return *instance; }
 			GLFWwindow* GetNativeWindow() const { return NativeWindow; }
 			LayerStack& GetLayerStack() { return *LayerStack; }
+			FramePacer& GetFramePacer() { return Pacer; }
 			AudioPlayer& GetAudioPlayer() { return AudioPlayer; }
+			SessionCache& GetSessionCache() { return Sessions; }
+			Playlist& GetPlaylist() { return Playlist; }
 			const Config::Settings& GetSettings() const { return Settings; }
 
 		private:
 			static App* instance;
 
+			void OpenMainMenu();
+			//Removes the music layer, its sound stays resident while its session is cached
+			void CloseGame();
 			void SetFullScreen(int monitor);
 			void SetWindowIcon(const std::string& path);
 
 			GLFWwindow* NativeWindow;
 			LayerStack* LayerStack = new OnBeat::LayerStack();
 			AudioPlayer AudioPlayer;
+			SessionCache Sessions;
+			Playlist Playlist;
 			Config::Settings Settings;
+			FramePacer Pacer;
+			bool Running = true;
+			float LastFrameTime = 0.0f;
 
 
 			//Layers
 			MusicLayer* MusicLayer = nullptr;
 			MainMenu* MainMenu = nullptr;
+			CalibrationLayer* CalibrationLayer = nullptr;
 	};
 }
\ No newline at end of file
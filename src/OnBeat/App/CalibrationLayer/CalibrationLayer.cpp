@@ -0,0 +1,162 @@
+#include <OnBeat/App/CalibrationLayer/CalibrationLayer.h>
+#include <OnBeat/App/App.h>
+#include <Hazel/Renderer/RenderCommand.h>
+#include <Hazel/Renderer/Renderer2D.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cmath>
+
+namespace OnBeat
+{
+	CalibrationLayer::CalibrationLayer(double interval, size_t taps)
+		: Layer("CalibrationLayer"), Interval(interval), Taps(taps)
+	{
+		const Config::Settings& settings = App::Get().GetSettings();
+		ClearColour = settings.Game.Skin.MusicSkin.ClearColour;
+		CancelKey = settings.Input.PAUSE;
+	}
+
+	void CalibrationLayer::OnAttach()
+	{
+		Input::Get().Clear();
+		Clock.Reset();
+		BeginPhase(Phase::Listen);
+	}
+
+	void CalibrationLayer::OnDetach()
+	{
+		App::Get().GetAudioPlayer().SetMetronome(0.0);
+	}
+
+	void CalibrationLayer::BeginPhase(Phase phase)
+	{
+		//The metronome keeps running between phases so the clock never jumps, only the clicks are muted
+		Current = phase;
+		Offsets.clear();
+		PhaseStart = Time;
+		if (phase != Phase::Done)
+		{
+			App::Get().GetAudioPlayer().SetMetronome(Interval, phase == Phase::Listen);
+		}
+	}
+
+	void CalibrationLayer::OnUpdate(Hazel::Timestep ts)
+	{
+		auto& audio = App::Get().GetAudioPlayer();
+		Time = Clock.Update(audio.GetMetronomeTime() - audio.GetOutputLatency(), ts.GetSeconds(), true);
+		int64_t now = Input::Now();
+
+		KeyPress press;
+		while (Input::Get().Pop(press))
+		{
+			if (!press.Pressed)
+				continue;
+
+			if (press.Key == CancelKey)
+			{
+				Close(false);
+				return;
+			}
+			if (Current == Phase::Done)
+				continue;
+
+			//Taps carry their own timestamps so the frame rate does not enter the measurement
+			double tap = Time - (now - press.Time) / 1e9;
+			if (tap < PhaseStart + Interval * OB_CALIBRATION_WARMUP)
+				continue;
+
+			Offsets.push_back(tap - std::round(tap / Interval) * Interval);
+			if (Offsets.size() < Taps)
+				continue;
+
+			if (Current == Phase::Listen)
+			{
+				Listened = OffsetEstimate::Estimate(Offsets);
+				BeginPhase(Phase::Watch);
+			}
+			else
+			{
+				Watched = OffsetEstimate::Estimate(Offsets);
+				BeginPhase(Phase::Done);
+			}
+		}
+
+		Hazel::RenderCommand::SetClearColor(ClearColour);
+		Hazel::RenderCommand::Clear();
+
+		//Flash on the beat while watching, fading over the first part of the interval
+		if (Current == Phase::Watch && Time >= 0.0)
+		{
+			double phase = std::fmod(Time, Interval) / Interval;
+			float alpha = (float)std::exp(-phase * 12.0);
+			auto& window = App::Get().GetWindow();
+
+			Hazel::Renderer2D::BeginScene(*CameraController);
+			Hazel::Renderer2D::DrawQuad({ 0.0f, 0.0f, 0.0f },
+				{ window.GetWidth() / 100.0f, window.GetHeight() / 100.0f }, { 1.0f, 1.0f, 1.0f, alpha });
+			Hazel::Renderer2D::EndScene();
+		}
+	}
+
+	void CalibrationLayer::OnImGuiRender()
+	{
+		ImGui::Begin("Calibration");
+		switch (Current)
+		{
+			case Phase::Listen:
+				ImGui::Text("Tap any key on each click you hear (%zu/%zu)", Offsets.size(), Taps);
+				break;
+			case Phase::Watch:
+				ImGui::Text("Tap any key on each flash you see (%zu/%zu)", Offsets.size(), Taps);
+				break;
+			case Phase::Done:
+			{
+				//Listening is audio plus input delay, watching is input plus display delay
+				double audioOffset = (Listened.Offset - Watched.Offset) * 1000.0;
+				double inputOffset = Watched.Offset * 1000.0;
+				ImGui::Text("Audio offset: %.1f ms (spread %.1f ms, %zu rejected)",
+					audioOffset, Listened.Spread * 1000.0, Listened.Rejected);
+				ImGui::Text("Input offset: %.1f ms (spread %.1f ms, %zu rejected)",
+					inputOffset, Watched.Spread * 1000.0, Watched.Rejected);
+
+				if (Listened.Valid && Watched.Valid)
+				{
+					if (ImGui::Button("Apply"))
+						Close(true);
+					ImGui::SameLine();
+				}
+				else
+				{
+					ImGui::Text("Taps were too inconsistent to use, try again");
+				}
+				if (ImGui::Button("Retry"))
+					BeginPhase(Phase::Listen);
+				break;
+			}
+		}
+		ImGui::Text("Press the pause key to leave");
+		ImGui::End();
+	}
+
+	void CalibrationLayer::Close(bool apply)
+	{
+		if (Closing)
+			return;
+		Closing = true;
+
+		if (apply)
+		{
+			Config::Settings settings = App::Get().GetSettings();
+			settings.Audio.AudioOffset = (int16_t)std::clamp(std::lround((Listened.Offset - Watched.Offset) * 1000.0), -500L, 500L);
+			settings.Audio.InputOffset = (int16_t)std::clamp(std::lround(Watched.Offset * 1000.0), -500L, 500L);
+			App::Get().SetSettings(settings);
+		}
+
+		App::Get().GetLayerStack().SetCallback([]() { App::Get().EndCalibration(); });
+	}
+
+	CalibrationLayer::~CalibrationLayer()
+	{
+
+	}
+}
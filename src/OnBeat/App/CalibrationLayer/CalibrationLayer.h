@@ -0,0 +1,57 @@
+#pragma once
+#include <OnBeat/App/CalibrationLayer/OffsetEstimate/OffsetEstimate.h>
+#include <OnBeat/Config/Config.h>
+#include <OnBeat/Util/AudioPlayer/AudioClock/AudioClock.h>
+#include <OnBeat/Util/Template/Layer.h>
+#include <vector>
+
+#define OB_CALIBRATION_INTERVAL 0.5
+#define OB_CALIBRATION_TAPS 24
+//Beats at the start of each phase not counted while the player finds the rhythm
+#define OB_CALIBRATION_WARMUP 4
+
+namespace OnBeat
+{
+	//Tap along to a metronome that is heard and then one that is seen
+	//Listening measures audio plus input delay, watching measures input and display delay on their own
+	class CalibrationLayer : public Layer
+	{
+		public:
+			enum class Phase
+			{
+				Listen,
+				Watch,
+				Done
+			};
+
+			CalibrationLayer(double interval = OB_CALIBRATION_INTERVAL, size_t taps = OB_CALIBRATION_TAPS);
+			~CalibrationLayer();
+
+			void OnAttach() override;
+			void OnDetach() override;
+			void OnUpdate(Hazel::Timestep ts) override;
+			virtual void OnImGuiRender() override;
+
+		private:
+			void BeginPhase(Phase phase);
+			//Stores the offsets in the settings when apply is set and goes back to the menu
+			void Close(bool apply);
+
+			Phase Current = Phase::Listen;
+			double Interval;
+			size_t Taps;
+
+			//Metronome time smoothed the same way gameplay smooths song time
+			AudioClock Clock;
+			double Time = 0.0;
+			double PhaseStart = 0.0;
+
+			std::vector<double> Offsets;
+			OffsetEstimate Listened;
+			OffsetEstimate Watched;
+
+			glm::vec4 ClearColour;
+			int CancelKey;
+			bool Closing = false;
+	};
+}
@@ -0,0 +1,51 @@
+#include <OnBeat/App/CalibrationLayer/OffsetEstimate/OffsetEstimate.h>
+#include <algorithm>
+#include <cmath>
+
+namespace OnBeat
+{
+	static double Median(std::vector<double> values)
+	{
+		size_t middle = values.size() / 2;
+		std::nth_element(values.begin(), values.begin() + middle, values.end());
+		double median = values[middle];
+		if (values.size() % 2 == 0)
+		{
+			median = (median + *std::max_element(values.begin(), values.begin() + middle)) / 2.0;
+		}
+		return median;
+	}
+
+	OffsetEstimate OffsetEstimate::Estimate(const std::vector<double>& offsets)
+	{
+		OffsetEstimate estimate;
+		if (offsets.empty())
+			return estimate;
+
+		double centre = Median(offsets);
+		std::vector<double> deviations;
+		deviations.reserve(offsets.size());
+		for (double offset : offsets)
+		{
+			deviations.push_back(std::abs(offset - centre));
+		}
+		//1.4826 makes the MAD match the standard deviation of normally spread taps
+		estimate.Spread = 1.4826 * Median(deviations);
+
+		//Floor the limit so a very steady player does not reject half their taps
+		double limit = std::max(3.0 * estimate.Spread, 0.005);
+		std::vector<double> inliers;
+		for (double offset : offsets)
+		{
+			if (std::abs(offset - centre) <= limit)
+				inliers.push_back(offset);
+		}
+
+		estimate.Offset = Median(inliers);
+		estimate.Used = inliers.size();
+		estimate.Rejected = offsets.size() - inliers.size();
+		//Lots of outliers means the taps were not following the beat at all
+		estimate.Valid = estimate.Used >= 8 && estimate.Used * 4 >= offsets.size() * 3;
+		return estimate;
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace OnBeat
+{
+	//Robust centre of tap offsets, taps far from the median are rejected using the median absolute deviation
+	struct OffsetEstimate
+	{
+		//Seconds, positive when taps land late
+		double Offset = 0.0;
+		//Median absolute deviation scaled to a standard deviation
+		double Spread = 0.0;
+		size_t Used = 0;
+		size_t Rejected = 0;
+		bool Valid = false;
+
+		static OffsetEstimate Estimate(const std::vector<double>& offsets);
+	};
+}
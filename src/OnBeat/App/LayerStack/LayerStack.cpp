@@ -1,5 +1,6 @@
 #include <OnBeat/App/LayerStack/LayerStack.h>
 #include <OnBeat/Util/Discord/Integration.h>
+#include <OnBeat/Util/Jobs/Jobs.h>
 
 namespace OnBeat {
 
@@ -14,6 +15,8 @@ namespace OnBeat {
 		{
 			(*it)->OnUpdate(ts);
 		}
+		//Continuations of finished jobs and other main thread work
+		JobSystem::Get().RunMainThread();
 		if (callback)
 		{
 			callback();
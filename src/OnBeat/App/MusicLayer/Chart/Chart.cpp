@@ -0,0 +1,42 @@
+#include <OnBeat/App/MusicLayer/Chart/Chart.h>
+#include <algorithm>
+
+namespace OnBeat
+{
+	Chart::Chart(int columns)
+		: columns(columns)
+	{
+	}
+
+	void Chart::Add(int column, int64_t sample)
+	{
+		columns[column].push_back(sample);
+	}
+
+	void Chart::Finalise()
+	{
+		for (auto& column : columns)
+		{
+			std::sort(column.begin(), column.end());
+			column.erase(std::unique(column.begin(), column.end()), column.end());
+		}
+	}
+
+	void Chart::Clear()
+	{
+		for (auto& column : columns)
+		{
+			column.clear();
+		}
+	}
+
+	size_t Chart::GetNoteCount() const
+	{
+		size_t count = 0;
+		for (auto& column : columns)
+		{
+			count += column.size();
+		}
+		return count;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace OnBeat
+{
+	//Notes stored as one sorted array of sample times per column
+	class Chart
+	{
+		public:
+			Chart(int columns = 4);
+
+			void Add(int column, int64_t sample);
+			//Sort and remove duplicates, must be called before the chart is drawn or judged
+			void Finalise();
+			void Clear();
+
+			int GetColumnCount() const { return (int)columns.size(); }
+			size_t GetNoteCount() const;
+			const std::vector<int64_t>& GetColumn(int column) const { return columns[column]; }
+
+		private:
+			std::vector<std::vector<int64_t>> columns;
+	};
+}
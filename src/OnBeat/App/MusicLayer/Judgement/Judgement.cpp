@@ -0,0 +1,96 @@
+#include <OnBeat/App/MusicLayer/Judgement/Judgement.h>
+#include <algorithm>
+#include <cmath>
+
+namespace OnBeat
+{
+	Judgement::Judgement(HitWindows windows)
+		: Windows(windows)
+	{
+	}
+
+	void Judgement::Reset(const Chart& chart, double sampleRate)
+	{
+		Columns.assign(chart.GetColumnCount(), {});
+		Cursors.assign(chart.GetColumnCount(), 0);
+		for (int c = 0; c < chart.GetColumnCount(); c++)
+		{
+			const std::vector<int64_t>& notes = chart.GetColumn(c);
+			Columns[c].reserve(notes.size());
+			for (int64_t sample : notes)
+			{
+				Columns[c].push_back(sample / sampleRate);
+			}
+		}
+		CurrentScore = Score();
+		OffsetCount = 0;
+	}
+
+	HitResult Judgement::Press(int column, double time)
+	{
+		if (column < 0 || column >= (int)Columns.size())
+			return {};
+
+		//Anything this press is already too late for was missed
+		const std::vector<double>& notes = Columns[column];
+		size_t& cursor = Cursors[column];
+		while (cursor < notes.size() && notes[cursor] < time - Windows.Miss)
+		{
+			Record({ Hit::Miss, column, time - notes[cursor] });
+			cursor++;
+		}
+
+		if (cursor == notes.size())
+			return {};
+
+		//Too early for the next note, ignore the press
+		double offset = time - notes[cursor];
+		double distance = std::abs(offset);
+		if (distance > Windows.Miss)
+			return {};
+
+		HitResult result{ Hit::Miss, column, offset };
+		if (distance <= Windows.Perfect)
+		{
+			result.Type = Hit::Perfect;
+		}
+		else if (distance <= Windows.Good)
+		{
+			result.Type = Hit::Good;
+		}
+		cursor++;
+		Record(result);
+		return result;
+	}
+
+	void Judgement::Update(double time)
+	{
+		for (size_t c = 0; c < Columns.size(); c++)
+		{
+			const std::vector<double>& notes = Columns[c];
+			size_t& cursor = Cursors[c];
+			while (cursor < notes.size() && notes[cursor] < time - Windows.Miss)
+			{
+				Record({ Hit::Miss, (int)c, time - notes[cursor] });
+				cursor++;
+			}
+		}
+	}
+
+	void Judgement::Record(const HitResult& result)
+	{
+		CurrentScore.Counts[(size_t)result.Type]++;
+		if (result.Type == Hit::Miss)
+		{
+			CurrentScore.Combo = 0;
+			return;
+		}
+
+		CurrentScore.Combo++;
+		CurrentScore.MaxCombo = std::max(CurrentScore.MaxCombo, CurrentScore.Combo);
+
+		//Running mean of hit offsets, the basis for calibration
+		OffsetCount++;
+		CurrentScore.MeanOffset += (result.Offset - CurrentScore.MeanOffset) / OffsetCount;
+	}
+}
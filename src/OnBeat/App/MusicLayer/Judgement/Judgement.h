@@ -0,0 +1,68 @@
+#pragma once
+#include <OnBeat/App/MusicLayer/Chart/Chart.h>
+#include <array>
+#include <vector>
+
+namespace OnBeat
+{
+	enum class Hit
+	{
+		Perfect,
+		Good,
+		Miss,
+		None
+	};
+
+	//Seconds either side of the note
+	struct HitWindows
+	{
+		double Perfect = 0.02;
+		double Good = 0.06;
+		double Miss = 0.12;
+	};
+
+	struct HitResult
+	{
+		Hit Type = Hit::None;
+		int Column = 0;
+		//Press time minus note time, negative is early
+		double Offset = 0.0;
+	};
+
+	//Matches presses against the chart with one cursor per column
+	//Each note is passed over once so judging is amortised O(1) per press
+	class Judgement
+	{
+		public:
+			struct Score
+			{
+				std::array<uint32_t, 3> Counts = { 0, 0, 0 };
+				uint32_t Combo = 0;
+				uint32_t MaxCombo = 0;
+				double MeanOffset = 0.0;
+			};
+
+			Judgement(HitWindows windows = HitWindows());
+
+			//Note times are copied out of the chart in seconds
+			void Reset(const Chart& chart, double sampleRate);
+
+			//Press at song time in seconds
+			HitResult Press(int column, double time);
+			//Notes whose window has closed by time become misses
+			void Update(double time);
+
+			void SetWindows(const HitWindows& windows) { Windows = windows; }
+			const HitWindows& GetWindows() const { return Windows; }
+			const Score& GetScore() const { return CurrentScore; }
+
+		private:
+			void Record(const HitResult& result);
+
+			HitWindows Windows;
+			std::vector<std::vector<double>> Columns;
+			std::vector<size_t> Cursors;
+			Score CurrentScore;
+			uint32_t OffsetCount = 0;
+	};
+}
@@ -1,21 +1,19 @@
 #include <OnBeat/App/MusicLayer/MusicLayer.h>
 #include <OnBeat/App/App.h>
 #include <Hazel/Renderer/RenderCommand.h>
+#include <imgui.h>
+#include <algorithm>
+#include <chrono>
 
 namespace OnBeat {
 	MusicLayer::MusicLayer(const std::string& file,
 		float cameraVelocity, double sampleRate, int sampleSize)
 		:
 		Layer("MusicLayer"),
-		BeatGenerator(OnSetOptions
-			{
-				App::Get().GetSettings().Game.ThresholdConstant,
-				App::Get().GetSettings().Game.ThresholdMultiple,
-				App::Get().GetSettings().Game.MeanWindow,
-				App::Get().GetSettings().Game.MaximaWindow
-			}
-		),
+		Options(CreateOnSetOptions(App::Get().GetSettings().Game)),
+		CurrentDifficulty((Difficulty)App::Get().GetSettings().Game.Difficulty),
 		CameraVelocity(cameraVelocity),
+		Sim(App::Get().GetAudioPlayer()),
 		SampleRate(sampleRate),
 		SampleSize(sampleSize),
 		file(file)
@@ -23,122 +21,142 @@ namespace OnBeat {
 		auto& window = App::Get().GetWindow();
 
 		skin = App::Get().GetSettings().Game.Skin.MusicSkin;
+		skin.Resolve((float)window.GetWidth(), (float)window.GetHeight());
+		Notes.SetLanes(skin.Lanes);
+		Notes.SetBeat(skin.Beat.Command);
+
+		RefreshInput(App::Get().GetSettings());
 
 		DiscordPresence();
 
+		//Replays of a recent song skip loading entirely
+		SessionKey = SessionCache::Key(file, Options, GetColumnCount());
+		if (auto session = App::Get().GetSessionCache().Find(SessionKey))
+		{
+			Restore(*session);
+			return;
+		}
+
 		LoadingLayer = new OnBeat::LoadingLayer(BindLoadingFunction(&MusicLayer::LoadLayer),
 			BindLoadingCallback(&MusicLayer::ClearLoadingLayer), true);
 	}
 
-	void MusicLayer::CreateBeatArea()
+	OnSetOptions MusicLayer::CreateOnSetOptions(const Config::GameConfig& game)
 	{
-		//Needs to be cleaned up
-		auto& window = App::Get().GetWindow();
+		OnSetOptions options
+		{
+			game.ThresholdConstant,
+			game.ThresholdMultiple,
+			game.MeanWindow,
+			game.MaximaWindow
+		};
+		options.GridDivision = game.GridDivision;
+		options.Mode = (OnSetMode)game.DetectionMode;
+		options.Percussive = (bool)game.Percussive;
+		options.Bands = game.Bands;
+		return options;
+	}
 
-		float length = window.GetHeight() / 100.0f;
+	void MusicLayer::RefreshInput(const Config::Settings& settings)
+	{
+		const Config::InputConfig& input = settings.Input;
+		std::vector<int> columnKeys = { input.COLUMN_1, input.COLUMN_2, input.COLUMN_3, input.COLUMN_4 };
+
+		HitWindows windows;
+		windows.Perfect = settings.Game.PerfectWindow / 1000.0;
+		windows.Good = settings.Game.GoodWindow / 1000.0;
+		windows.Miss = settings.Game.MissWindow / 1000.0;
+		//Presses arrive late by both the audio and input delay, the picture only by the audio delay
+		VisualOffset = settings.Audio.AudioOffset / 1000.0;
+		PauseKey = input.PAUSE;
+		Sim.SetInput(columnKeys, windows, (settings.Audio.AudioOffset + settings.Audio.InputOffset) / 1000.0);
+	}
 
-		float yOffset = CameraController->GetPosition().y;
-		//Background
-		skin.BackgroundTexture.draw(-0.5f, 0, yOffset);
+	void MusicLayer::CreateBeatArea()
+	{
+		auto& window = App::Get().GetWindow();
 
-		//Beat Columns
-		for (auto& column : skin.Columns)
+		//Everything under the notes only changes on resize so it is drawn from the cache
+		Playfield.Draw(*CameraController, [this]()
 		{
-			column.draw(-0.1f, 0.0f, yOffset);
-		}
+			//Background
+			skin.BackgroundTexture.draw(-0.5f);
 
-		//Beat Background
-		skin.BeatArea.draw(-0.15f, 0.0f, yOffset);
+			//Beat Columns
+			for (auto& column : skin.Columns)
+			{
+				column.draw(-0.1f);
+			}
 
-		//Beat Zone
-		skin.BeatZone.draw(0.2f, 0.0f, yOffset - App::Get().GetWindow().GetHeight() / 200);
+			//Beat Background
+			skin.BeatArea.draw(-0.15f);
+		}, window.GetWidth(), window.GetHeight(), -0.1f);
+
+		//Beat Zone sits above the notes
+		float yOffset = CameraController->GetPosition().y;
+		Hazel::Renderer2D::BeginScene(*CameraController);
+		skin.BeatZone.draw(0.2f, 0.0f, yOffset - window.GetHeight() / 200);
+		Hazel::Renderer2D::EndScene();
 	}
 
 	void MusicLayer::CreateBeats()
 	{
-		//Iterate through timing vector and create any within two windows up one window down
-		float beatTextureHeight, beatTextureWidth;
-		try
-		{
-			Hazel::Ref<Hazel::Texture2D> beatTexture = std::get<Hazel::Ref<Hazel::Texture2D>>(skin.Beat.Colour);
-			beatTextureHeight = beatTexture->GetHeight() / 100.0f;
-			beatTextureWidth = beatTexture->GetWidth() / 100.0f;
-
-		}
-		catch (std::bad_variant_access const&)
+		//Notes are uploaded once per chart, scrolling is the camera plus one offset uniform
+		if (NotesDirty)
 		{
-			glm::vec2 beatTexture = skin.Beat.toScaleVec();
-			beatTextureHeight = beatTexture[1];
-			beatTextureWidth = beatTexture[0];
+			Notes.Upload(*CurrentChart, SampleRate);
+			NotesDirty = false;
 		}
-		for (const auto& [key, vector] : BeatHeights)
-		{
-			float zIndex = 0.01f;
-			int index = 0;
 
-			//Calculate beat size per column
-			Skin::Quad column = skin.Columns[key - 1];
+		float offsetY = (App::Get().GetWindow().GetHeight() / 200) + skin.BeatZone.getY();
+		Notes.Draw(*CameraController, CameraVelocity, -offsetY);
+	}
 
-			float scale = std::abs(column.getX() - skin.Columns[key].getX()) / beatTextureWidth;
-			skin.Beat.scaleX = std::to_string(scale * beatTextureWidth);
-			skin.Beat.scaleY = std::to_string(scale * beatTextureHeight);
+	int MusicLayer::GetColumnCount() const
+	{
+		return (int)skin.Columns.size() - 1;
+	}
 
-			float offsetX = column.getX() + (scale * beatTextureWidth / 2);
-			float offsetY = (App::Get().GetWindow().GetHeight() / 200) + skin.BeatZone.getY();
+	Chart MusicLayer::CreateChart(const AudioVector& beats, const OnSetOptions& options, int columns, int sampleSize)
+	{
+		Chart chart(columns);
 
-			for (auto& value : vector)
-			{
-				//Check if beat is above current window region
-				if (value > CameraController->GetPosition().y + beatTextureHeight + (2 * App::Get().GetWindow().GetHeight() / 100.0f))
-				{
-					//Break if not visible
-					break;
-				}
-				//Check if beat is below current window region
-				else if (value < CameraController->GetPosition().y - (App::Get().GetWindow().GetHeight() / 100.0f))
-				{
-					continue;
-				}
+		//Notes are stored by the sample at the end of their frame
+		//Possible adjustment needed to represent middle of sample size however sample size so small likely unneccessary
 
-				//Draw beats
-				//Cannot use quad draw due to render time calculating string to float
-				try
-				{
-					Hazel::Renderer2D::DrawQuad(
-						{ offsetX, value - offsetY, zIndex },
-						{ scale * beatTextureWidth, scale * beatTextureHeight }, std::get<Hazel::Ref<Hazel::Texture2D>>(skin.Beat.Colour));
-				}
-				catch (std::bad_variant_access const&)
+		//Multi-band charts map bands low to high across the columns
+		if (options.Bands > 0 && options.Mode == OnSetMode::Spectral)
+		{
+			for (int b = 0; b < beats.size(); b++)
+			{
+				int column = (b * chart.GetColumnCount()) / (int)beats.size();
+				for (int n = 0; n < beats[b].size(); n++)
 				{
-					Hazel::Renderer2D::DrawQuad(
-						{ offsetX, value - offsetY, zIndex },
-						{ scale * beatTextureWidth, scale * beatTextureHeight }, std::get<glm::vec4>(skin.Beat.Colour));
+					if (beats[b][n] != 0)
+					{
+						chart.Add(column, (int64_t)sampleSize * (n + 1));
+					}
 				}
-				//Draw each beat at a higher z index
-				zIndex += 0.001f;
 			}
-		
+
+			//Several bands can share a column, finalise keeps each one ordered and unique
+			chart.Finalise();
+			return chart;
 		}
-	}
 
-	void MusicLayer::FindBeatHeights()
-	{
-		//Blit y = Camera velocity * time of blit
-		//Possible adjustment needed to represent middle of sample size however sample size so small likely unneccessary
-		double time = (SampleSize) / SampleRate;
 		for (int c = 0; c < beats.size(); c++)
 		{
 			double threshold = OnSetDetection::FindPeakThreshold(beats[c]);
 			int opt1, opt2;
 			if (c == 0)
 			{
-				opt1 = 1;
-				opt2 = 2;
+				opt1 = 0;
+				opt2 = 1;
 			}
 			else
 			{
-				opt1 = 3;
-				opt2 = 4;
+				opt1 = 2;
+				opt2 = 3;
 			}
 
 			for (int n = 0; n < beats[c].size(); n++)
@@ -147,10 +165,31 @@ namespace OnBeat {
 				{
 					continue;
 				}
-				BeatHeights[(beats[c][n] > threshold) ? opt1 : opt2].push_back(CameraVelocity * (float)time * (n+1));
+				chart.Add((beats[c][n] > threshold) ? opt1 : opt2, (int64_t)sampleSize * (n + 1));
 			}
 		}
 
+		chart.Finalise();
+		return chart;
+	}
+
+	void MusicLayer::SetDifficulty(Difficulty difficulty)
+	{
+		//Swapping charts mid song would reset the score, the settings apply from the next play
+		if (Sim.GetRunning())
+		{
+			if (difficulty != CurrentDifficulty)
+				HZ_INFO("Difficulty changes apply from the next play");
+			return;
+		}
+
+		//All levels are generated at load so switching only moves the pointer
+		size_t index = std::min((size_t)difficulty, Charts.size() - 1);
+		CurrentChart = &Charts[index];
+		CurrentDifficulty = (Difficulty)index;
+		//The upload happens on the next draw
+		NotesDirty = true;
+		Sim.SetChart(CurrentChart, SampleRate);
 	}
 
 	void MusicLayer::OnAttach()
@@ -159,7 +198,7 @@ namespace OnBeat {
 
 	void MusicLayer::OnDetach()
 	{
-
+		Sim.Stop();
 	}
 
 	void MusicLayer::OnUpdate(Hazel::Timestep ts)
@@ -171,6 +210,48 @@ namespace OnBeat {
 		if (!loaded)
 			return;
 
+		//Loading is asynchronous, the sound may finish well after the charts
+		auto& audio = App::Get().GetAudioPlayer();
+		if (!SoundMeasured && !LoadingLayer && audio.GetLoaded())
+		{
+			SoundMeasured = true;
+			if (RestoreStart != std::chrono::steady_clock::time_point())
+			{
+				std::chrono::duration<double, std::milli> restore = std::chrono::steady_clock::now() - RestoreStart;
+				HZ_INFO("Replay ready {0:.2f} ms after it started", restore.count());
+			}
+			else
+			{
+				App::Get().GetSessionCache().SetSoundBytes(SessionKey, audio.GetSoundBytes());
+			}
+		}
+
+		//Headless audio only mixes when asked, every frame plays a 60th of a second of song
+		if (audio.GetHeadless() && Sim.GetRunning())
+		{
+			HeadlessSamples += audio.GetOutputRate() / 60.0;
+			unsigned int block = audio.GetBlockLength();
+			unsigned int blocks = (unsigned int)(HeadlessSamples / block);
+			HeadlessSamples -= (double)blocks * block;
+			Sim.Advance(blocks);
+		}
+
+		//Camera follows the simulation's song time carried forward to this frame
+		const SimulationState& state = Sim.Read();
+		double songTime = Simulation::Interpolate(state) - VisualOffset;
+
+		//Song over, the playlist moves on or the menu comes back
+		//A single song stays on screen once it ends, as it always has
+		if (!Leaving && !App::Get().GetPlaylist().Empty() && audio.GetLoaded() && audio.GetLength() &&
+			Simulation::Interpolate(state) * 1000.0 >= audio.GetLength())
+		{
+			Leaving = true;
+			App::Get().GetLayerStack().SetCallback([]() { App::Get().NextSong(); });
+		}
+		glm::vec3 cameraPos = CameraController->GetPosition();
+		cameraPos.y = CameraVelocity * (float)songTime;
+		CameraController->SetPosition(cameraPos);
+
 		Hazel::Renderer2D::ResetStats();
 		{
 			Hazel::RenderCommand::SetClearColor(skin.ClearColour);
@@ -179,32 +260,83 @@ namespace OnBeat {
 
 		//Rendering scope
 		{
-			Hazel::Renderer2D::BeginScene(*CameraController);
 			//Draw background
 			CreateBeatArea();
+
+			//Notes bypass the batch renderer, depth keeps them between the columns and the beat zone
 			CreateBeats();
-			Hazel::Renderer2D::EndScene();
 		}	 
-	
-		//TODO(Callum): Regulate framerate
-		glm::vec3 cameraPos = CameraController->GetPosition();
-		cameraPos.y += CameraVelocity * ts.GetSeconds();
-		CameraController->SetPosition(cameraPos);
 	}
 
 	void MusicLayer::OnEvent(Hazel::Event& e)
 	{
 		Hazel::EventDispatcher dispatcher(e);
 		dispatcher.Dispatch<Hazel::KeyReleasedEvent>(HZ_BIND_EVENT_FN(MusicLayer::OnKeyRelease));
+		dispatcher.Dispatch<Hazel::WindowResizeEvent>(HZ_BIND_EVENT_FN(MusicLayer::OnResize));
 		Layer::OnEvent(e);
 	}
 
+	bool MusicLayer::OnResize(Hazel::WindowResizeEvent& e)
+	{
+		//Skin layout only changes with the window
+		skin.Resolve((float)e.GetWidth(), (float)e.GetHeight());
+		Notes.SetLanes(skin.Lanes);
+		Playfield.Invalidate();
+		return false;
+	}
+
 	void MusicLayer::OnImGuiRender()
 	{
+#ifndef DIST
+		//Skin draw cost is measured by benchmarks/BeatBenchmark, this shows what the game is doing
+		if (!loaded)
+			return;
+
+		auto stats = Hazel::Renderer2D::GetStats();
+		ImGui::Begin("Stats");
+		auto& pacer = App::Get().GetFramePacer().GetStats();
+		ImGui::Text("Paced: %.3f ms jitter %.3f ms (spin %.3f ms, GPU wait %.3f ms)",
+			pacer.FrameTime, pacer.Jitter, pacer.SpinTime, pacer.GpuWait);
+		ImGui::Text("Quads: %u Draw calls: %u", stats.QuadCount, stats.DrawCalls);
+		ImGui::Text("Notes: %u", Notes.GetNoteCount());
+		auto& playfield = Playfield.GetStats();
+		ImGui::Text("Playfield cache: %u quads, %u draw calls saved per frame (%u rebuilds)",
+			playfield.QuadsSaved, playfield.DrawCallsSaved, playfield.Rebuilds);
+		const SimulationState& state = Sim.Read();
+		auto& clock = state.Clock;
+		ImGui::Text("Audio drift: %.3f ms (max %.3f ms, %llu snaps)",
+			clock.Drift * 1000.0, clock.MaxDrift * 1000.0, (unsigned long long)clock.Snaps);
+		auto& audio = App::Get().GetAudioPlayer();
+		ImGui::Text("Output: %d Hz, %.2f ms latency, %llu samples played",
+			audio.GetOutputRate(), audio.GetOutputLatency() * 1000.0, (unsigned long long)audio.GetPositionSamples());
+		auto hitsounds = audio.GetHitsounds().GetStats();
+		ImGui::Text("Hitsounds: %.2f ms press to sound (max %.2f ms), %llu played, %llu stolen, %llu dropped",
+			hitsounds.Latency, hitsounds.MaxLatency, (unsigned long long)hitsounds.Triggers,
+			(unsigned long long)hitsounds.Steals, (unsigned long long)hitsounds.Dropped);
+		auto& score = state.Score;
+		ImGui::Text("Perfect: %u Good: %u Miss: %u Combo: %u (max %u)",
+			score.Counts[(size_t)Hit::Perfect], score.Counts[(size_t)Hit::Good], score.Counts[(size_t)Hit::Miss],
+			score.Combo, score.MaxCombo);
+		ImGui::Text("Mean offset: %.2f ms", score.MeanOffset * 1000.0);
+		auto& sessions = App::Get().GetSessionCache().GetStats();
+		ImGui::Text("Sessions: %zu songs, %.1f MB (%u hits, %u misses, %u evicted)",
+			sessions.Songs, sessions.Bytes / (1024.0 * 1024.0), sessions.Hits, sessions.Misses, sessions.Evictions);
+		auto& playlist = App::Get().GetPlaylist();
+		if (playlist.HasNext())
+			ImGui::Text("Next song: %.0f%% analysed", playlist.GetPreloadProgress() * 100.0f);
+		ImGui::End();
+#endif
 	}
 
 	bool MusicLayer::OnKeyRelease(Hazel::KeyReleasedEvent& e)
 	{
+		//Pause only backs out of loading, in game it does nothing yet
+		if (e.GetKeyCode() != PauseKey || Leaving || !LoadingLayer)
+			return true;
+
+		//Stop the job and leave when the loading layer pops
+		Leaving = true;
+		LoadingLayer->Cancel();
 		return true;
 	}
 
@@ -227,27 +359,108 @@ namespace OnBeat {
 	void MusicLayer::ClearLoadingLayer()
 	{
 		delete LoadingLayer;
+		LoadingLayer = nullptr;
+
+		//The job has returned so its session is only touched here, play starts on the main thread
+		if (Session && !Failed)
+		{
+			if (!Leaving)
+				Begin(*Session);
+			//Stored with the analysis estimate of the sound, the update corrects it once the sound is loaded
+			App::Get().GetSessionCache().Store(SessionKey, file, Session);
+		}
+		Session = nullptr;
+
+		//Deletes this layer, nothing can follow it
+		if (Failed)
+			App::Get().NextSong();
+		else if (Leaving)
+			App::Get().EndGame();
 	}
 
-	void MusicLayer::LoadLayer()
+	std::shared_ptr<SongSession> MusicLayer::Analyse(const std::string& file, const OnSetOptions& options,
+		int columns, double sampleRate, int sampleSize, const OnSetProgress& progress)
 	{
+		//Analysis is most of the work, unless the library scheduler or an earlier play left it on disk
+		AnalysisResult analysis;
+		bool analysed = AnalysisCache::Analyse(file, options, sampleSize, (int)sampleRate, analysis, [&progress](double done)
+			{
+				return !progress || progress(done * 0.8);
+			});
+		if ((progress && !progress(0.8)) || !analysed)
+			return nullptr;
+
+		auto session = std::make_shared<SongSession>();
+		//FMOD decodes to 16 bit PCM, the real size replaces this once the audio player has loaded it
+		session->SoundBytes = analysis.SoundBytes;
+
+		//Snap onsets to the estimated beat grid
+		double frameRate = sampleRate / sampleSize;
+		session->Tempo = OnSetDetection::EstimateTempo(analysis.Odf, frameRate);
+		HZ_TRACE("Estimated tempo: {0} bpm (confidence {1})", session->Tempo.Bpm, session->Tempo.Confidence);
+		AudioVector beats = OnSetDetection::QuantiseBeats(analysis.Peaks, session->Tempo, frameRate, options.GridDivision);
+		if (progress && !progress(0.85))
+			return nullptr;
+
+		//Every difficulty from the one peak set, thinned by note density
+		std::vector<AudioVector> levels = OnSetDetection::SelectDifficulties(beats, frameRate,
+			std::vector<double>(DifficultyDensity.begin(), DifficultyDensity.end()));
+		for (size_t d = 0; d < levels.size(); d++)
+		{
+			session->Charts[d] = CreateChart(levels[d], options, columns, sampleSize);
+		}
+		if (progress && !progress(1.0))
+			return nullptr;
+		return session;
+	}
 
-		//Load all beats in a threaded process
-
+	void MusicLayer::LoadLayer(JobHandle& job)
+	{
+		//Load all beats in a pooled job
 		App::Get().GetAudioPlayer().LoadAudio(file);
 
-		beats = BeatGenerator.FindBeats(BeatGenerator.ProcessFile(file));
-
-		HZ_ASSERT(beats.size() != 0, "Invalid beats vector.");
+		Session = Analyse(file, Options, GetColumnCount(), SampleRate, SampleSize, [&job](double progress)
+			{
+				job.SetProgress((float)progress);
+				return !job.GetCancelled();
+			});
+		if (job.GetCancelled())
+			return;
+		if (!Session)
+		{
+			HZ_ERROR("Could not analyse {0}", file);
+			Failed = true;
+		}
+	}
 
+	void MusicLayer::Restore(const SongSession& session)
+	{
+		//The audio player still holds the decoded sound, loading it is a rewind
+		RestoreStart = std::chrono::steady_clock::now();
+		App::Get().GetAudioPlayer().LoadAudio(file);
+		Begin(session);
+	}
 
-		FindBeatHeights();
+	void MusicLayer::Begin(const SongSession& session)
+	{
+		//The session keeps its own copy for replays
+		Charts = session.Charts;
+		Tempo = session.Tempo;
+		SetDifficulty(CurrentDifficulty);
 		loaded = true;
 		App::Get().GetAudioPlayer().PlayAudio();
+		Sim.Start();
 	}
 
 	MusicLayer::~MusicLayer()
 	{
-
+		//Closed before loading finished, the job writes into this layer so it has to return first
+		if (LoadingLayer)
+		{
+			LoadingLayer->Cancel();
+			LoadingLayer->Wait();
+			App::Get().GetLayerStack().PopLayer(LoadingLayer);
+			delete LoadingLayer;
+		}
 	}
 }
\ No newline at end of file
@@ -1,9 +1,22 @@
 #pragma once
+#include <OnBeat/Config/Config.h>
 #include <OnBeat/Util/Loader/LoadingLayer/LoadingLayer.h>
 #include <OnBeat/Util/OnSetDetection/OnSetDetection.h>
+#include <OnBeat/Util/OnSetDetection/AnalysisCache/AnalysisCache.h>
+#include <OnBeat/App/MusicLayer/Chart/Chart.h>
+#include <OnBeat/App/MusicLayer/NoteRenderer/NoteRenderer.h>
+#include <OnBeat/App/MusicLayer/PlayfieldCache/PlayfieldCache.h>
+#include <OnBeat/App/MusicLayer/SessionCache/SessionCache.h>
+#include <OnBeat/App/MusicLayer/Simulation/Simulation.h>
 #include <Hazel/Renderer/Shader.h>
 #include <Hazel/Renderer/Renderer2D.h>
 #include <Hazel/Events/KeyEvent.h>
+#include <atomic>
+#include <chrono>
+
+//Framing every analysis uses, cached results on disk are only valid for these
+#define OB_ANALYSIS_SAMPLE_RATE 44100
+#define OB_ANALYSIS_FRAME_SIZE 512
 
 namespace OnBeat
 {
@@ -26,22 +39,57 @@ namespace OnBeat
 			virtual void OnImGuiRender() override;
 
 			bool OnKeyRelease(Hazel::KeyReleasedEvent& e);
+			bool OnResize(Hazel::WindowResizeEvent& e);
+
+			void SetDifficulty(Difficulty difficulty);
+			Difficulty GetDifficulty() const { return CurrentDifficulty; }
+
+			//Column keys, hit windows and calibrated offsets
+			void RefreshInput(const Config::Settings& settings);
+
+			const std::string& GetSessionKey() const { return SessionKey; }
+			const OnSetOptions& GetOptions() const { return Options; }
+			//Playable columns, the skin has one more line than it has lanes
+			int GetColumnCount() const;
+
+			static OnSetOptions CreateOnSetOptions(const Config::GameConfig& game);
+			//Decode, analysis and a chart per difficulty, null when progress cancels it or nothing was found
+			//Runs off the main thread, both loading and playlist preloading use it
+			static std::shared_ptr<SongSession> Analyse(const std::string& file, const OnSetOptions& options,
+				int columns, double sampleRate, int sampleSize, const OnSetProgress& progress = nullptr);
 
 		private:
 			//Textures & Shading
 			void CreateBeatArea();
-			void FindBeatHeights();
+			static Chart CreateChart(const AudioVector& beats, const OnSetOptions& options, int columns, int sampleSize);
 			void CreateBeats();
 
-			OnSetDetection BeatGenerator;
+			OnSetOptions Options;
 
 			Skin::MusicSkin skin;
 
-			std::unordered_map<int, std::vector<float>> BeatHeights;
+			//One chart per difficulty, all built at load
+			std::array<Chart, DifficultyDensity.size()> Charts;
+			Chart* CurrentChart = &Charts[0];
+			Difficulty CurrentDifficulty;
+
+			//Static note buffer for the current chart
+			NoteRenderer Notes;
+			std::atomic<bool> NotesDirty = false;
+
+			//Background, columns and beat area
+			PlayfieldCache Playfield;
 
 			//Blit calculations
-			AudioVector beats;
+			TempoEstimate Tempo;
 			float CameraVelocity;
+			//Seconds the picture is held back so notes meet the line when they are heard
+			double VisualOffset = 0.0;
+
+			//Song time, input and judgement run at a fixed rate off the render thread
+			Simulation Sim;
+			//Headless audio only, output samples owed to the next frame's blocks
+			double HeadlessSamples = 0.0;
 
 			int SampleSize;
 			double SampleRate;
@@ -51,9 +99,27 @@ namespace OnBeat
 			void DiscordPresence();
 
 			//Loading functionality
-			void LoadLayer();
+			//Starts straight from a cached session, no loading layer or analysis
+			void Restore(const SongSession& session);
+			//Main thread only, the loading job just builds the session
+			void Begin(const SongSession& session);
+			void LoadLayer(JobHandle& job);
 			void ClearLoadingLayer();
 			LoadingLayer* LoadingLayer = nullptr;
+			//Set by Begin, the frame and ImGui only draw once it is
 			bool loaded = false;
+			//Pause was pressed while loading, the menu opens once the cancelled job returns
+			bool Leaving = false;
+			//The song could not be analysed, a playlist skips it and a single song goes back to the menu
+			bool Failed = false;
+			//The audio player has reported the song loaded, its decoded size is known from then
+			bool SoundMeasured = false;
+			//Replays log how long the resident sound took to be ready
+			std::chrono::steady_clock::time_point RestoreStart;
+			int PauseKey;
+
+			//Built by the loading job, played and stored once the loading layer pops
+			std::string SessionKey;
+			std::shared_ptr<SongSession> Session;
 	};
 }
\ No newline at end of file
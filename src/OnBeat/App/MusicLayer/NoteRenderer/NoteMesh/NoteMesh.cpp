@@ -0,0 +1,42 @@
+#include <OnBeat/App/MusicLayer/NoteRenderer/NoteMesh/NoteMesh.h>
+#include <algorithm>
+
+namespace OnBeat
+{
+	namespace
+	{
+		const float Corners[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+	}
+
+	void NoteMesh::Build(const Chart& chart, double sampleRate)
+	{
+		Vertices.clear();
+		Vertices.reserve(chart.GetNoteCount() * 4);
+		int columns = std::min(chart.GetColumnCount(), OB_MAX_LANES);
+		for (int c = 0; c < columns; c++)
+		{
+			for (int64_t sample : chart.GetColumn(c))
+			{
+				float time = (float)(sample / sampleRate);
+				for (auto& corner : Corners)
+				{
+					Vertices.push_back({ time, { corner[0], corner[1] }, (float)c });
+				}
+			}
+		}
+
+		uint32_t notes = GetNoteCount();
+		Indices.resize(notes * 6);
+		for (uint32_t n = 0; n < notes; n++)
+		{
+			uint32_t offset = n * 4;
+			uint32_t* quad = &Indices[n * 6];
+			quad[0] = offset + 0;
+			quad[1] = offset + 1;
+			quad[2] = offset + 2;
+			quad[3] = offset + 2;
+			quad[4] = offset + 3;
+			quad[5] = offset + 0;
+		}
+	}
+}
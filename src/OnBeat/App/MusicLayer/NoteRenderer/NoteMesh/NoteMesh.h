@@ -0,0 +1,33 @@
+#pragma once
+#include <OnBeat/App/MusicLayer/Chart/Chart.h>
+#include <cstdint>
+#include <vector>
+
+#define OB_MAX_LANES 16
+
+namespace OnBeat
+{
+	//Vertex layout of assets/shaders/Note.glsl
+	struct NoteVertex
+	{
+		float Time;
+		float Corner[2];
+		float Lane;
+	};
+
+	//CPU side of the note buffer, kept apart from the renderer so it can be built and tested without one
+	class NoteMesh
+	{
+		public:
+			//Four corners and six indices per note, columns past OB_MAX_LANES are left out
+			void Build(const Chart& chart, double sampleRate);
+
+			const std::vector<NoteVertex>& GetVertices() const { return Vertices; }
+			const std::vector<uint32_t>& GetIndices() const { return Indices; }
+			uint32_t GetNoteCount() const { return (uint32_t)(Vertices.size() / 4); }
+
+		private:
+			std::vector<NoteVertex> Vertices;
+			std::vector<uint32_t> Indices;
+	};
+}
@@ -0,0 +1,93 @@
+#include <OnBeat/App/MusicLayer/NoteRenderer/NoteRenderer.h>
+#include <Hazel/Renderer/RenderCommand.h>
+#include <Hazel/Core/Log.h>
+#include <algorithm>
+#include <string>
+
+namespace OnBeat
+{
+	NoteRenderer::NoteRenderer()
+	{
+		Lanes.fill(glm::vec3(0.0f));
+		for (int l = 0; l < OB_MAX_LANES; l++)
+		{
+			LaneUniforms[l] = "u_Lanes[" + std::to_string(l) + "]";
+		}
+	}
+
+	void NoteRenderer::Upload(const Chart& chart, double sampleRate)
+	{
+		//GL objects are created lazily so the layer can be built off the render thread
+		if (!NoteShader)
+		{
+			NoteShader = Hazel::Shader::Create(OB_NOTE_SHADER);
+
+			uint32_t white = 0xffffffff;
+			WhiteTexture = Hazel::Texture2D::Create(1, 1);
+			WhiteTexture->SetData(&white, sizeof(uint32_t));
+		}
+
+		NoteMesh mesh;
+		mesh.Build(chart, sampleRate);
+		if (chart.GetColumnCount() > OB_MAX_LANES)
+		{
+			HZ_WARN("Chart has {0} columns, only {1} are drawn", chart.GetColumnCount(), OB_MAX_LANES);
+		}
+
+		NoteCount = mesh.GetNoteCount();
+		if (NoteCount == 0)
+		{
+			Notes = nullptr;
+			return;
+		}
+
+		Notes = Hazel::VertexArray::Create();
+		Hazel::Ref<Hazel::VertexBuffer> vertexBuffer = Hazel::VertexBuffer::Create(
+			(float*)mesh.GetVertices().data(), (uint32_t)(mesh.GetVertices().size() * sizeof(NoteVertex)));
+		vertexBuffer->SetLayout({
+			{ Hazel::ShaderDataType::Float, "a_Time" },
+			{ Hazel::ShaderDataType::Float2, "a_Corner" },
+			{ Hazel::ShaderDataType::Float, "a_Lane" }
+		});
+		Notes->AddVertexBuffer(vertexBuffer);
+		Notes->SetIndexBuffer(Hazel::IndexBuffer::Create((uint32_t*)mesh.GetIndices().data(), (uint32_t)mesh.GetIndices().size()));
+	}
+
+	void NoteRenderer::SetLanes(const std::vector<Skin::MusicSkin::Lane>& lanes)
+	{
+		LaneCount = std::min((int)lanes.size(), OB_MAX_LANES);
+		for (int l = 0; l < LaneCount; l++)
+		{
+			Lanes[l] = { lanes[l].X, lanes[l].BeatSize.x, lanes[l].BeatSize.y };
+		}
+	}
+
+	void NoteRenderer::SetBeat(const Skin::DrawCommand& beat)
+	{
+		Beat = beat;
+	}
+
+	void NoteRenderer::Draw(const Hazel::OrthographicCamera& camera, float velocity, float offset, float z)
+	{
+		if (!Notes)
+			return;
+
+		NoteShader->Bind();
+		NoteShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+		NoteShader->SetFloat("u_Velocity", velocity);
+		NoteShader->SetFloat("u_Offset", offset);
+		NoteShader->SetFloat("u_Depth", z);
+		NoteShader->SetFloat4("u_Tint", Beat.Tint);
+		for (int l = 0; l < LaneCount; l++)
+		{
+			NoteShader->SetFloat3(LaneUniforms[l], Lanes[l]);
+		}
+
+		//Flat colour beats sample a white texel so one shader covers both
+		(Beat.Texture ? Beat.Texture : WhiteTexture)->Bind(0);
+		NoteShader->SetInt("u_Texture", 0);
+
+		Notes->Bind();
+		Hazel::RenderCommand::DrawIndexed(Notes);
+	}
+}
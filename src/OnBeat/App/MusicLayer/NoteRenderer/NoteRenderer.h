@@ -0,0 +1,41 @@
+#pragma once
+#include <OnBeat/App/MusicLayer/NoteRenderer/NoteMesh/NoteMesh.h>
+#include <OnBeat/Config/Skin.h>
+#include <Hazel/Renderer/VertexArray.h>
+#include <Hazel/Renderer/Shader.h>
+#include <Hazel/Renderer/OrthographicCamera.h>
+#include <array>
+
+#define OB_NOTE_SHADER "assets/shaders/Note.glsl"
+
+namespace OnBeat
+{
+	//Draws a whole chart from one static vertex buffer
+	//Per frame cost is a handful of uniforms and one draw call regardless of note count
+	class NoteRenderer
+	{
+		public:
+			NoteRenderer();
+
+			//Rebuild the vertex buffer, must be called on the render thread
+			void Upload(const Chart& chart, double sampleRate);
+			void SetLanes(const std::vector<Skin::MusicSkin::Lane>& lanes);
+			void SetBeat(const Skin::DrawCommand& beat);
+
+			//Notes sit at time * velocity + offset in world space
+			void Draw(const Hazel::OrthographicCamera& camera, float velocity, float offset, float z = 0.01f);
+
+			uint32_t GetNoteCount() const { return NoteCount; }
+
+		private:
+			Hazel::Ref<Hazel::Shader> NoteShader;
+			Hazel::Ref<Hazel::VertexArray> Notes;
+			Hazel::Ref<Hazel::Texture2D> WhiteTexture;
+
+			Skin::DrawCommand Beat;
+			std::array<glm::vec3, OB_MAX_LANES> Lanes;
+			std::array<std::string, OB_MAX_LANES> LaneUniforms;
+			int LaneCount = 0;
+			uint32_t NoteCount = 0;
+	};
+}
@@ -0,0 +1,97 @@
+#include <OnBeat/App/MusicLayer/PlayfieldCache/PlayfieldCache.h>
+#include <Hazel/Renderer/Renderer2D.h>
+#include <Hazel/Renderer/RenderCommand.h>
+#include <glad/glad.h>
+
+namespace OnBeat
+{
+	PlayfieldCache::PlayfieldCache()
+	{
+	}
+
+	void PlayfieldCache::Draw(const Hazel::OrthographicCamera& camera, const DrawFunction& draw,
+		uint32_t width, uint32_t height, float z)
+	{
+		if (width == 0 || height == 0)
+			return;
+
+		if (Dirty || !Cache)
+		{
+			Rebuild(camera, draw, width, height);
+		}
+
+		//Cache covers the whole view so it follows the camera
+		glm::vec3 position = camera.GetPosition();
+		CompositeShader->Bind();
+		CompositeShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+		CompositeShader->SetFloat2("u_Origin", { position.x, position.y });
+		CompositeShader->SetFloat2("u_Size", { width / 100.0f, height / 100.0f });
+		CompositeShader->SetFloat("u_Depth", z);
+		CompositeShader->SetInt("u_Texture", 0);
+		glBindTextureUnit(0, Cache->GetColorAttachmentRendererID());
+
+		CompositeQuad->Bind();
+		Hazel::RenderCommand::DrawIndexed(CompositeQuad);
+	}
+
+	void PlayfieldCache::Rebuild(const Hazel::OrthographicCamera& camera, const DrawFunction& draw,
+		uint32_t width, uint32_t height)
+	{
+		//GL objects are created on first use so the owner can be built off the render thread
+		if (!CompositeShader)
+		{
+			CompositeShader = Hazel::Shader::Create(OB_COMPOSITE_SHADER);
+
+			float corners[] = {
+				-0.5f, -0.5f,
+				 0.5f, -0.5f,
+				 0.5f,  0.5f,
+				-0.5f,  0.5f
+			};
+			uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+
+			CompositeQuad = Hazel::VertexArray::Create();
+			Hazel::Ref<Hazel::VertexBuffer> vertexBuffer = Hazel::VertexBuffer::Create(corners, sizeof(corners));
+			vertexBuffer->SetLayout({
+				{ Hazel::ShaderDataType::Float2, "a_Corner" }
+			});
+			CompositeQuad->AddVertexBuffer(vertexBuffer);
+			CompositeQuad->SetIndexBuffer(Hazel::IndexBuffer::Create(indices, 6));
+		}
+
+		if (!Cache)
+		{
+			Hazel::FramebufferSpecification spec;
+			spec.Attachments = { Hazel::FramebufferTextureFormat::RGBA8, Hazel::FramebufferTextureFormat::Depth };
+			spec.Width = width;
+			spec.Height = height;
+			Cache = Hazel::Framebuffer::Create(spec);
+		}
+		else if (Cache->GetSpecification().Width != width || Cache->GetSpecification().Height != height)
+		{
+			Cache->Resize(width, height);
+		}
+
+		//Same projection at the origin, the composite quad moves with the real camera
+		Hazel::OrthographicCamera still = camera;
+		still.SetPosition({ 0.0f, 0.0f, 0.0f });
+
+		auto before = Hazel::Renderer2D::GetStats();
+		Cache->Bind();
+		Hazel::RenderCommand::SetClearColor({ 0.0f, 0.0f, 0.0f, 0.0f });
+		Hazel::RenderCommand::Clear();
+		Hazel::Renderer2D::BeginScene(still);
+		draw();
+		Hazel::Renderer2D::EndScene();
+		Cache->Unbind();
+		auto after = Hazel::Renderer2D::GetStats();
+
+		//The composite itself costs one quad and one draw call
+		uint32_t quads = after.QuadCount - before.QuadCount;
+		uint32_t drawCalls = after.DrawCalls - before.DrawCalls;
+		Stats.QuadsSaved = quads > 1 ? quads - 1 : 0;
+		Stats.DrawCallsSaved = drawCalls > 1 ? drawCalls - 1 : 0;
+		Stats.Rebuilds++;
+		Dirty = false;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <Hazel/Renderer/Framebuffer.h>
+#include <Hazel/Renderer/VertexArray.h>
+#include <Hazel/Renderer/Shader.h>
+#include <Hazel/Renderer/OrthographicCamera.h>
+#include <functional>
+
+#define OB_COMPOSITE_SHADER "assets/shaders/Composite.glsl"
+
+namespace OnBeat
+{
+	//Renders static playfield quads once to a framebuffer and composites them with one quad
+	class PlayfieldCache
+	{
+		public:
+			typedef std::function<void()> DrawFunction;
+
+			struct Statistics
+			{
+				uint32_t Rebuilds = 0;
+				//Saved every frame the cache is reused
+				uint32_t QuadsSaved = 0;
+				uint32_t DrawCallsSaved = 0;
+			};
+
+			PlayfieldCache();
+
+			//Next draw rebuilds, call on resize or skin change
+			void Invalidate() { Dirty = true; }
+
+			//Draw calls Renderer2D quads relative to the camera origin, must not be inside a scene
+			void Draw(const Hazel::OrthographicCamera& camera, const DrawFunction& draw,
+				uint32_t width, uint32_t height, float z);
+
+			const Statistics& GetStats() const { return Stats; }
+
+		private:
+			void Rebuild(const Hazel::OrthographicCamera& camera, const DrawFunction& draw,
+				uint32_t width, uint32_t height);
+
+			Hazel::Ref<Hazel::Framebuffer> Cache;
+			Hazel::Ref<Hazel::VertexArray> CompositeQuad;
+			Hazel::Ref<Hazel::Shader> CompositeShader;
+
+			bool Dirty = true;
+			Statistics Stats;
+	};
+}
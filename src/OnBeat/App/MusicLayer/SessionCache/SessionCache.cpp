@@ -0,0 +1,117 @@
+#include <OnBeat/App/MusicLayer/SessionCache/SessionCache.h>
+#include <sstream>
+
+namespace OnBeat
+{
+	size_t SongSession::GetBytes() const
+	{
+		size_t bytes = sizeof(SongSession) + SoundBytes;
+		for (auto& chart : Charts)
+		{
+			bytes += chart.GetNoteCount() * sizeof(int64_t);
+		}
+		return bytes;
+	}
+
+	SessionCache::SessionCache(size_t songs, size_t budget)
+		: MaxSongs(songs), Budget(budget)
+	{
+	}
+
+	std::string SessionCache::Key(const std::string& file, const OnSetOptions& options, int columns)
+	{
+		std::ostringstream key;
+		key << file << '|' << options.ThresholdConstant << '|' << options.ThresholdMultiple << '|'
+			<< options.MeanWindow << '|' << options.MaximaWindow << '|' << options.GridDivision << '|'
+			<< (int)options.Mode << '|' << options.Percussive << '|' << options.MedianWindow << '|'
+			<< options.Bands << '|' << columns;
+		return key.str();
+	}
+
+	std::shared_ptr<const SongSession> SessionCache::Find(const std::string& key)
+	{
+		auto it = Index.find(key);
+		if (it == Index.end())
+		{
+			Stats.Misses++;
+			return nullptr;
+		}
+
+		Entries.splice(Entries.begin(), Entries, it->second);
+		Stats.Hits++;
+		return it->second->Session;
+	}
+
+	void SessionCache::Store(const std::string& key, const std::string& file, std::shared_ptr<const SongSession> session)
+	{
+		auto it = Index.find(key);
+		if (it != Index.end())
+		{
+			Stats.Bytes -= it->second->Bytes;
+			Entries.erase(it->second);
+			Index.erase(it);
+		}
+
+		Entry entry;
+		entry.Key = key;
+		entry.File = file;
+		entry.Session = std::move(session);
+		entry.Bytes = entry.Session->GetBytes();
+		Stats.Bytes += entry.Bytes;
+
+		Entries.push_front(std::move(entry));
+		Index[key] = Entries.begin();
+		Evict();
+		Stats.Songs = Entries.size();
+	}
+
+	void SessionCache::SetSoundBytes(const std::string& key, size_t bytes)
+	{
+		auto it = Index.find(key);
+		if (it == Index.end())
+			return;
+
+		Entry& entry = *it->second;
+		Stats.Bytes -= entry.Bytes;
+		entry.Bytes = entry.Session->GetBytes() - entry.Session->SoundBytes + bytes;
+		Stats.Bytes += entry.Bytes;
+		Evict();
+		Stats.Songs = Entries.size();
+	}
+
+	void SessionCache::Clear()
+	{
+		while (!Entries.empty())
+		{
+			Remove(std::prev(Entries.end()));
+		}
+		Stats.Songs = 0;
+	}
+
+	void SessionCache::Evict()
+	{
+		//The newest entry always stays, even when it alone is over budget
+		while (Entries.size() > 1 && (Entries.size() > MaxSongs || Stats.Bytes > Budget))
+		{
+			Remove(std::prev(Entries.end()));
+			Stats.Evictions++;
+		}
+	}
+
+	void SessionCache::Remove(std::list<Entry>::iterator entry)
+	{
+		std::string file = entry->File;
+		Stats.Bytes -= entry->Bytes;
+		Index.erase(entry->Key);
+		Entries.erase(entry);
+
+		//Other options on the same file still use its sound
+		for (auto& other : Entries)
+		{
+			if (other.File == file)
+				return;
+		}
+		if (OnEvict)
+			OnEvict(file);
+	}
+}
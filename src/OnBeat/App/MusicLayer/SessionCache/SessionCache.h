@@ -0,0 +1,80 @@
+#pragma once
+#include <OnBeat/App/MusicLayer/Chart/Chart.h>
+#include <OnBeat/Util/OnSetDetection/OnSetOptions.h>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#define OB_SESSION_CACHE_SONGS 4
+#define OB_SESSION_CACHE_BYTES (512ull * 1024 * 1024)
+
+namespace OnBeat
+{
+	//Everything a MusicLayer builds while loading, enough to start again without analysis
+	struct SongSession
+	{
+		std::array<Chart, DifficultyDensity.size()> Charts;
+		TempoEstimate Tempo;
+		//Decoded PCM the audio player keeps resident for this song
+		size_t SoundBytes = 0;
+
+		size_t GetBytes() const;
+	};
+
+	//Recently played songs, least recently used first out past the song count or byte budget
+	//Main thread only
+	class SessionCache
+	{
+		public:
+			//Called with the song file when its last session leaves, so the sound can be freed
+			typedef std::function<void(const std::string&)> EvictFunction;
+
+			struct Statistics
+			{
+				uint32_t Hits = 0;
+				uint32_t Misses = 0;
+				uint32_t Evictions = 0;
+				size_t Bytes = 0;
+				size_t Songs = 0;
+			};
+
+			SessionCache(size_t songs = OB_SESSION_CACHE_SONGS, size_t budget = OB_SESSION_CACHE_BYTES);
+
+			//Charts depend on the analysis options and column count as well as the file
+			static std::string Key(const std::string& file, const OnSetOptions& options, int columns);
+
+			//Marks the session as most recent, null on a miss
+			std::shared_ptr<const SongSession> Find(const std::string& key);
+			bool Contains(const std::string& key) const { return Index.count(key) != 0; }
+			void Store(const std::string& key, const std::string& file, std::shared_ptr<const SongSession> session);
+			//The sound finishes decoding after its session is stored, its real size replaces the estimate
+			void SetSoundBytes(const std::string& key, size_t bytes);
+			void Clear();
+
+			void SetEvictCallback(EvictFunction fn) { OnEvict = fn; }
+			const Statistics& GetStats() const { return Stats; }
+
+		private:
+			struct Entry
+			{
+				std::string Key;
+				std::string File;
+				std::shared_ptr<const SongSession> Session;
+				size_t Bytes = 0;
+			};
+
+			void Evict();
+			void Remove(std::list<Entry>::iterator entry);
+
+			//Most recent at the front
+			std::list<Entry> Entries;
+			std::unordered_map<std::string, std::list<Entry>::iterator> Index;
+
+			size_t MaxSongs;
+			size_t Budget;
+			EvictFunction OnEvict;
+			Statistics Stats;
+	};
+}
@@ -0,0 +1,172 @@
+#include <OnBeat/App/MusicLayer/Simulation/Simulation.h>
+#include <OnBeat/Util/Input/Input.h>
+#include <algorithm>
+#include <chrono>
+
+namespace OnBeat
+{
+	Simulation::Simulation(AudioPlayer& audio, int rate)
+		: Audio(audio), Rate(rate)
+	{
+	}
+
+	void Simulation::Start()
+	{
+		if (Running)
+			return;
+
+		Clock.Reset();
+		Input::Get().Clear();
+		LastTick = Input::Now();
+		Running = true;
+		if (!Audio.GetHeadless())
+		{
+			Thread = std::thread(&Simulation::Run, this);
+		}
+	}
+
+	bool Simulation::Advance(unsigned int blocks)
+	{
+		if (!Running || !Audio.GetHeadless())
+			return false;
+
+		for (unsigned int i = 0; i < blocks; i++)
+		{
+			if (!Audio.Advance(1))
+				return false;
+
+			int64_t now = Input::Now();
+			Tick((now - LastTick) / 1e9, now);
+			LastTick = now;
+		}
+		return true;
+	}
+
+	void Simulation::Stop()
+	{
+		Running = false;
+		if (Thread.joinable())
+		{
+			Thread.join();
+		}
+	}
+
+	void Simulation::SetChart(const Chart* chart, double sampleRate)
+	{
+		std::lock_guard<std::mutex> lock(Pending.Lock);
+		Pending.NewChart = chart;
+		Pending.SampleRate = sampleRate;
+		Pending.ChartChanged = true;
+		Pending.Changed = true;
+	}
+
+	void Simulation::SetInput(const std::vector<int>& columnKeys, const HitWindows& windows, double offset)
+	{
+		std::lock_guard<std::mutex> lock(Pending.Lock);
+		Pending.ColumnKeys = columnKeys;
+		Pending.Windows = windows;
+		Pending.InputOffset = offset;
+		Pending.Changed = true;
+	}
+
+	double Simulation::Interpolate(const SimulationState& state)
+	{
+		if (!state.Playing)
+			return state.SongTime;
+
+		//Never reach further than a stalled tick would explain
+		double elapsed = (Input::Now() - state.Time) / 1e9;
+		return state.SongTime + std::clamp(elapsed, 0.0, 0.05);
+	}
+
+	void Simulation::Run()
+	{
+		auto period = std::chrono::nanoseconds(1000000000 / Rate);
+		auto next = std::chrono::steady_clock::now();
+
+		while (Running)
+		{
+			//Measured delta so a late wakeup delays the tick but never skews song time
+			int64_t now = Input::Now();
+			Tick((now - LastTick) / 1e9, now);
+			LastTick = now;
+
+			next += period;
+			std::this_thread::sleep_until(next);
+
+			//Resync after a long stall instead of running a burst of catch up ticks
+			auto late = std::chrono::steady_clock::now() - next;
+			if (late > period * 10)
+			{
+				next = std::chrono::steady_clock::now();
+			}
+		}
+	}
+
+	void Simulation::Tick(double delta, int64_t now)
+	{
+		ApplyPending();
+
+		bool playing = !Audio.GetPaused();
+		//The mixer runs a full output buffer ahead of what can be heard
+		double songTime = Clock.Update(Audio.GetPosition() - Audio.GetOutputLatency(), delta, playing);
+
+		//Presses carry their own timestamps so judgement does not depend on the tick either
+		KeyPress press;
+		while (Input::Get().Pop(press))
+		{
+			if (!press.Pressed)
+				continue;
+
+			auto key = std::find(ColumnKeys.begin(), ColumnKeys.end(), press.Key);
+			if (key == ColumnKeys.end())
+				continue;
+
+			double time = songTime - (now - press.Time) / 1e9 - InputOffset;
+			HitResult result = Judge.Press((int)(key - ColumnKeys.begin()), time);
+			if (result.Type != Hit::None)
+			{
+				LastHit = result;
+			}
+			//A press with no note in reach is silent rather than a miss sound
+			if (playing && result.Type != Hit::None)
+			{
+				Audio.GetHitsounds().Trigger(result.Type == Hit::Miss ? Hitsound::Miss : Hitsound::Hit, press.Time);
+			}
+		}
+		Judge.Update(songTime);
+
+		SimulationState& state = Snapshots.Write();
+		state.SongTime = songTime;
+		state.Time = now;
+		state.Playing = playing;
+		state.Tick = ++Ticks;
+		state.Score = Judge.GetScore();
+		state.LastHit = LastHit;
+		state.Clock = Clock.GetStats();
+		Snapshots.Publish();
+	}
+
+	void Simulation::ApplyPending()
+	{
+		if (!Pending.Changed.load(std::memory_order_acquire))
+			return;
+
+		std::lock_guard<std::mutex> lock(Pending.Lock);
+		if (Pending.ChartChanged && Pending.NewChart)
+		{
+			Judge.Reset(*Pending.NewChart, Pending.SampleRate);
+			LastHit = HitResult();
+		}
+		Pending.ChartChanged = false;
+		ColumnKeys = Pending.ColumnKeys;
+		Judge.SetWindows(Pending.Windows);
+		InputOffset = Pending.InputOffset;
+		Pending.Changed = false;
+	}
+
+	Simulation::~Simulation()
+	{
+		Stop();
+	}
+}
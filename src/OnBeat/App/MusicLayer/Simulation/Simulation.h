@@ -0,0 +1,91 @@
+#pragma once
+#include <OnBeat/App/MusicLayer/Judgement/Judgement.h>
+#include <OnBeat/Util/AudioPlayer/AudioPlayer.h>
+#include <OnBeat/Util/AudioPlayer/AudioClock/AudioClock.h>
+#include <OnBeat/Util/Queue/TripleBuffer.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define OB_SIMULATION_RATE 1000
+
+namespace OnBeat
+{
+	//Everything the renderer needs from one simulation tick
+	struct SimulationState
+	{
+		double SongTime = 0.0;
+		//Input::Now at the tick
+		int64_t Time = 0;
+		bool Playing = false;
+		uint64_t Tick = 0;
+
+		Judgement::Score Score;
+		//Latest press that reached a note
+		HitResult LastHit;
+		AudioClock::Statistics Clock;
+	};
+
+	//Fixed rate gameplay thread owning song time, input and judgement
+	//Rendering only reads snapshots so gameplay timing does not depend on the frame rate
+	class Simulation
+	{
+		public:
+			Simulation(AudioPlayer& audio, int rate = OB_SIMULATION_RATE);
+			~Simulation();
+
+			//A headless player gets no thread, the simulation ticks from Advance instead
+			void Start();
+			void Stop();
+			//Headless players only, mixes blocks one at a time and ticks after each so runs are repeatable
+			bool Advance(unsigned int blocks = 1);
+			bool GetRunning() const { return Running; }
+
+			//Set before Start, a new chart resets the score on the first tick
+			//The chart must outlive the simulation
+			void SetChart(const Chart* chart, double sampleRate);
+			//offset is seconds taken off every press, the calibrated audio and input delay
+			void SetInput(const std::vector<int>& columnKeys, const HitWindows& windows, double offset = 0.0);
+
+			//Latest snapshot, renderer thread only
+			const SimulationState& Read() { return Snapshots.Read(); }
+			//Song time of a snapshot carried forward to now
+			static double Interpolate(const SimulationState& state);
+
+		private:
+			void Run();
+			void Tick(double delta, int64_t now);
+			void ApplyPending();
+
+			AudioPlayer& Audio;
+			int Rate;
+
+			std::thread Thread;
+			std::atomic<bool> Running = false;
+			uint64_t Ticks = 0;
+			int64_t LastTick = 0;
+
+			//Simulation thread only
+			AudioClock Clock;
+			Judgement Judge;
+			HitResult LastHit;
+			std::vector<int> ColumnKeys;
+			double InputOffset = 0.0;
+
+			//Settings and chart changes handed over from the main thread
+			struct
+			{
+				std::mutex Lock;
+				std::atomic<bool> Changed = false;
+				const Chart* NewChart = nullptr;
+				double SampleRate = 44100.0;
+				bool ChartChanged = false;
+				std::vector<int> ColumnKeys;
+				HitWindows Windows;
+				double InputOffset = 0.0;
+			} Pending;
+
+			TripleBuffer<SimulationState> Snapshots;
+	};
+}
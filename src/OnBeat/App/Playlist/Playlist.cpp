@@ -0,0 +1,154 @@
+#include <OnBeat/App/Playlist/Playlist.h>
+#include <OnBeat/App/App.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+
+namespace OnBeat
+{
+	std::vector<std::string> Playlist::FromFolder(const std::string& first)
+	{
+		std::vector<std::string> songs;
+		std::filesystem::path start(first);
+		std::error_code error;
+		for (auto& entry : std::filesystem::directory_iterator(start.parent_path(), error))
+		{
+			if (!entry.is_regular_file())
+				continue;
+
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(),
+				[](unsigned char c) { return (char)std::tolower(c); });
+			if (extension == ".wav" || extension == ".mp3")
+				songs.push_back(entry.path().string());
+		}
+		std::sort(songs.begin(), songs.end());
+
+		//Songs before the chosen one are left out rather than wrapped round
+		auto it = std::find_if(songs.begin(), songs.end(), [&start](const std::string& song)
+			{
+				return std::filesystem::path(song) == start;
+			});
+		if (it == songs.end())
+			return { first };
+		songs.erase(songs.begin(), it);
+		return songs;
+	}
+
+	void Playlist::Set(std::vector<std::string> songs)
+	{
+		CancelPreload();
+		Songs = std::move(songs);
+		Position = 0;
+	}
+
+	void Playlist::Clear()
+	{
+		Set({});
+	}
+
+	bool Playlist::Advance()
+	{
+		if (!HasNext())
+			return false;
+		Position++;
+		return true;
+	}
+
+	void Playlist::PreloadNext(const OnSetOptions& options, int columns, double sampleRate, int sampleSize)
+	{
+		CancelPreload();
+		if (!HasNext())
+			return;
+
+		std::string file = Songs[Position + 1];
+		std::string key = SessionCache::Key(file, options, columns);
+		if (App::Get().GetSessionCache().Contains(key))
+		{
+			App::Get().GetAudioPlayer().PreloadSound(file);
+			Preload = JobHandle();
+			Preload.SetProgress(1.0f);
+			return;
+		}
+
+		Preload = JobHandle();
+		JobHandle job = Preload;
+		auto finished = std::make_shared<std::atomic<bool>>(false);
+		std::thread thread([this, job, finished, file, key, options, columns, sampleRate, sampleSize]()
+			{
+				RunPreload(job, file, key, options, columns, sampleRate, sampleSize);
+				finished->store(true, std::memory_order_release);
+			});
+		PreloadThreads.push_back({ std::move(thread), finished });
+	}
+
+	void Playlist::RunPreload(JobHandle job, const std::string& file, const std::string& key, const OnSetOptions& options,
+		int columns, double sampleRate, int sampleSize)
+	{
+		//One thread is the whole budget, analysis must not spread over the pool
+		JobSystem::SetSerial(true);
+
+		auto last = std::chrono::steady_clock::now();
+		auto session = MusicLayer::Analyse(file, options, columns, sampleRate, sampleSize, [this, &job, &last](double progress)
+			{
+				//Sleep in proportion to the work since the last report so the average stays in budget
+				auto worked = std::chrono::steady_clock::now() - last;
+				{
+					std::unique_lock<std::mutex> lock(PreloadLock);
+					PreloadWake.wait_for(lock, worked * ((1.0 - OB_PRELOAD_CPU_BUDGET) / OB_PRELOAD_CPU_BUDGET),
+						[&job]() { return job.GetCancelled(); });
+				}
+				last = std::chrono::steady_clock::now();
+
+				job.SetProgress((float)progress);
+				return !job.GetCancelled();
+			});
+		if (!session || job.GetCancelled())
+			return;
+
+		//Cancelled is checked again on the main thread, the playlist may have moved on since
+		JobSystem::Get().Post([job, file, key, session]()
+			{
+				if (job.GetCancelled())
+					return;
+				App::Get().GetSessionCache().Store(key, file, session);
+				App::Get().GetAudioPlayer().PreloadSound(file);
+			});
+	}
+
+	void Playlist::CancelPreload()
+	{
+		//Cuts the throttle sleep short, the analysis stops at its next progress report
+		{
+			std::lock_guard<std::mutex> lock(PreloadLock);
+			Preload.Cancel();
+		}
+		PreloadWake.notify_all();
+		Reap();
+	}
+
+	void Playlist::Reap()
+	{
+		for (auto it = PreloadThreads.begin(); it != PreloadThreads.end();)
+		{
+			if (!it->Finished->load(std::memory_order_acquire))
+			{
+				it++;
+				continue;
+			}
+			it->Thread.join();
+			it = PreloadThreads.erase(it);
+		}
+	}
+
+	Playlist::~Playlist()
+	{
+		//Only at exit is a decode worth waiting for
+		CancelPreload();
+		for (auto& preload : PreloadThreads)
+		{
+			preload.Thread.join();
+		}
+	}
+}
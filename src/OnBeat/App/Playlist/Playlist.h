@@ -0,0 +1,66 @@
+#pragma once
+#include <OnBeat/Util/Jobs/Jobs.h>
+#include <OnBeat/Util/OnSetDetection/OnSetDetection.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Share of one core the background analysis averages, it sleeps off the rest between progress reports
+#define OB_PRELOAD_CPU_BUDGET 0.25
+
+namespace OnBeat
+{
+	//Songs played back to back
+	//The next song is analysed on its own throttled thread while the current one plays and handed over through the session cache
+	class Playlist
+	{
+		public:
+			~Playlist();
+
+			//Every supported song in the folder of first in name order, starting at first
+			static std::vector<std::string> FromFolder(const std::string& first);
+
+			void Set(std::vector<std::string> songs);
+			//Also cancels any preload
+			void Clear();
+
+			bool Empty() const { return Songs.empty(); }
+			bool HasNext() const { return Position + 1 < Songs.size(); }
+			const std::string& GetCurrent() const { return Songs[Position]; }
+			//False at the end of the list
+			bool Advance();
+
+			//Analyses the next song into the session cache and opens its sound, any earlier preload is cancelled
+			void PreloadNext(const OnSetOptions& options, int columns, double sampleRate, int sampleSize);
+			//Never waits, the thread stops at its next progress report and is joined once it has
+			void CancelPreload();
+			float GetPreloadProgress() const { return Preload.GetProgress(); }
+
+		private:
+			std::vector<std::string> Songs;
+			size_t Position = 0;
+
+			struct PreloadThread
+			{
+				std::thread Thread;
+				std::shared_ptr<std::atomic<bool>> Finished;
+			};
+
+			//Body of a preload thread, throttled to OB_PRELOAD_CPU_BUDGET
+			void RunPreload(JobHandle job, const std::string& file, const std::string& key, const OnSetOptions& options,
+				int columns, double sampleRate, int sampleSize);
+			//Joins the threads that have returned
+			void Reap();
+
+			//Progress and cancellation only, the analysis runs on its own thread so its sleeps never hold a pool worker
+			JobHandle Preload;
+			//The newest is the running preload, cancelled ones can still be inside a decode and are joined later
+			std::vector<PreloadThread> PreloadThreads;
+			std::mutex PreloadLock;
+			std::condition_variable PreloadWake;
+	};
+}
@@ -89,11 +89,21 @@ namespace OnBeat
 		void to_json(json& j, const AudioConfig& c)
 		{
 			DEFAULT_SET(Volume);
+			DEFAULT_SET(LowLatency);
+			DEFAULT_SET(BufferLength);
+			DEFAULT_SET(BufferCount);
+			DEFAULT_SET(AudioOffset);
+			DEFAULT_SET(InputOffset);
 		}
 
 		void from_json(const json& j, AudioConfig& c)
 		{
 			c.Volume = j.value("Volume", (float)OB_UNDEFINED_INT);
+			DEFAULT_GET(LowLatency);
+			DEFAULT_GET(BufferLength);
+			DEFAULT_GET(BufferCount);
+			DEFAULT_GET(AudioOffset);
+			DEFAULT_GET(InputOffset);
 		}
 
 		void to_json(json& j, const GameConfig& c)
@@ -103,6 +113,16 @@ namespace OnBeat
 			DEFAULT_SET(ThresholdMultiple);
 			DEFAULT_SET(MeanWindow);
 			DEFAULT_SET(MaximaWindow);
+			DEFAULT_SET(GridDivision);
+			DEFAULT_SET(DetectionMode);
+			DEFAULT_SET(Percussive);
+			DEFAULT_SET(Bands);
+			DEFAULT_SET(Difficulty);
+			DEFAULT_SET(PerfectWindow);
+			DEFAULT_SET(GoodWindow);
+			DEFAULT_SET(MissWindow);
+			DEFAULT_SET(LibraryCores);
+			j["MusicFolders"] = c.MusicFolders;
 			j["Skin"] = c.Skin.SkinPath;
 		}
 
@@ -111,6 +131,16 @@ namespace OnBeat
 			DEFAULT_GET(CameraVelocity);
 			DEFAULT_GET(MeanWindow);
 			DEFAULT_GET(MaximaWindow);
+			DEFAULT_GET(GridDivision);
+			DEFAULT_GET(DetectionMode);
+			DEFAULT_GET(Percussive);
+			DEFAULT_GET(Bands);
+			DEFAULT_GET(Difficulty);
+			DEFAULT_GET(PerfectWindow);
+			DEFAULT_GET(GoodWindow);
+			DEFAULT_GET(MissWindow);
+			DEFAULT_GET(LibraryCores);
+			c.MusicFolders = j.value("MusicFolders", std::string());
 			c.ThresholdConstant = j.value("ThresholdConstant", (double)OB_UNDEFINED_INT);
 			c.ThresholdMultiple = j.value("ThresholdMultiple", (double)OB_UNDEFINED_INT);
 			c.Skin = Skin::AppSkin(j.value("Skin", OB_DEFAULT_SKIN));
@@ -155,6 +185,11 @@ namespace OnBeat
 
 			//Audio config
 			DEFAULT_SWAP(Audio.Volume);
+			DEFAULT_SWAP(Audio.LowLatency);
+			DEFAULT_SWAP(Audio.BufferLength);
+			DEFAULT_SWAP(Audio.BufferCount);
+			DEFAULT_SWAP(Audio.AudioOffset);
+			DEFAULT_SWAP(Audio.InputOffset);
 
 			//Game config
 			DEFAULT_SWAP(Game.CameraVelocity);
@@ -162,6 +197,16 @@ namespace OnBeat
 			DEFAULT_SWAP(Game.ThresholdMultiple);
 			DEFAULT_SWAP(Game.MeanWindow);
 			DEFAULT_SWAP(Game.MaximaWindow);
+			DEFAULT_SWAP(Game.GridDivision);
+			DEFAULT_SWAP(Game.DetectionMode);
+			DEFAULT_SWAP(Game.Percussive);
+			DEFAULT_SWAP(Game.Bands);
+			DEFAULT_SWAP(Game.Difficulty);
+			DEFAULT_SWAP(Game.PerfectWindow);
+			DEFAULT_SWAP(Game.GoodWindow);
+			DEFAULT_SWAP(Game.MissWindow);
+			DEFAULT_SWAP(Game.LibraryCores);
+			newS.Game.MusicFolders = oldS.Game.MusicFolders;
 
 			return true;
 		}
@@ -197,6 +242,11 @@ namespace OnBeat
 
 			//Audio config
 			DEFAULT_VALIDATE(Audio.Volume, 0, 1);
+			DEFAULT_VALIDATE(Audio.LowLatency, 0, 1);
+			DEFAULT_VALIDATE(Audio.BufferLength, 64, 4096);
+			DEFAULT_VALIDATE(Audio.BufferCount, 2, 16);
+			DEFAULT_VALIDATE(Audio.AudioOffset, -500, 500);
+			DEFAULT_VALIDATE(Audio.InputOffset, -500, 500);
 
 			//Game config
 			DEFAULT_VALIDATE(Game.CameraVelocity, 0, 100);
@@ -204,6 +254,15 @@ namespace OnBeat
 			DEFAULT_VALIDATE(Game.ThresholdMultiple, 0, 1);
 			DEFAULT_VALIDATE(Game.MeanWindow, 3, 32);
 			DEFAULT_VALIDATE(Game.MaximaWindow, 3, 32);
+			DEFAULT_VALIDATE(Game.GridDivision, 0, 16);
+			DEFAULT_VALIDATE(Game.DetectionMode, 0, 1);
+			DEFAULT_VALIDATE(Game.Percussive, 0, 1);
+			DEFAULT_VALIDATE(Game.Bands, 0, 32);
+			DEFAULT_VALIDATE(Game.Difficulty, 0, 3);
+			DEFAULT_VALIDATE(Game.PerfectWindow, 1, 500);
+			DEFAULT_VALIDATE(Game.GoodWindow, 1, 500);
+			DEFAULT_VALIDATE(Game.MissWindow, 1, 500);
+			DEFAULT_VALIDATE(Game.LibraryCores, 0, 64);
 
 			return true;
 		}
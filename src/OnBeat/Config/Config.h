@@ -190,6 +190,14 @@ namespace OnBeat
 		struct AudioConfig
 		{
 			float Volume = OB_UNDEFINED_INT;
+			uint16_t
+				LowLatency = OB_UNDEFINED_INT,
+				BufferLength = OB_UNDEFINED_INT,
+				BufferCount = OB_UNDEFINED_INT;
+			//Milliseconds, measured by calibration
+			int16_t
+				AudioOffset = OB_UNDEFINED_INT,
+				InputOffset = OB_UNDEFINED_INT;
 		};
 
 		void to_json(nlohmann::json& j, const AudioConfig& c);
@@ -200,10 +208,22 @@ namespace OnBeat
 			uint16_t
 				CameraVelocity = OB_UNDEFINED_INT,
 				MeanWindow = OB_UNDEFINED_INT,
-				MaximaWindow = OB_UNDEFINED_INT;
+				MaximaWindow = OB_UNDEFINED_INT,
+				GridDivision = OB_UNDEFINED_INT,
+				DetectionMode = OB_UNDEFINED_INT,
+				Percussive = OB_UNDEFINED_INT,
+				Bands = OB_UNDEFINED_INT,
+				Difficulty = OB_UNDEFINED_INT,
+				PerfectWindow = OB_UNDEFINED_INT,
+				GoodWindow = OB_UNDEFINED_INT,
+				MissWindow = OB_UNDEFINED_INT,
+				//Worker threads analysing the library while in the menus, 0 turns it off
+				LibraryCores = OB_UNDEFINED_INT;
 			double
 				ThresholdConstant = OB_UNDEFINED_INT,
 				ThresholdMultiple = OB_UNDEFINED_INT;
+			//Separated by ';'
+			std::string MusicFolders;
 			Skin::AppSkin Skin;
 		};
 
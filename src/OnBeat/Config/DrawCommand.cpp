@@ -0,0 +1,32 @@
+#include <OnBeat/Config/DrawCommand.h>
+#include <Hazel/Renderer/Renderer2D.h>
+
+namespace OnBeat
+{
+	namespace Skin
+	{
+		DrawCommand::DrawCommand(const ColourTexture& colour)
+		{
+			if (auto texture = std::get_if<Hazel::Ref<Hazel::Texture2D>>(&colour))
+			{
+				Texture = *texture;
+			}
+			else
+			{
+				Tint = std::get<glm::vec4>(colour);
+			}
+		}
+
+		void DrawCommand::Draw(const glm::vec3& position, const glm::vec2& size) const
+		{
+			if (Texture)
+			{
+				Hazel::Renderer2D::DrawQuad(position, size, Texture, 1.0f, Tint);
+			}
+			else
+			{
+				Hazel::Renderer2D::DrawQuad(position, size, Tint);
+			}
+		}
+	}
+}
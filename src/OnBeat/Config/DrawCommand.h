@@ -0,0 +1,24 @@
+#pragma once
+#include <Hazel/Renderer/Texture.h>
+#include <glm/glm.hpp>
+#include <variant>
+
+namespace OnBeat
+{
+	namespace Skin
+	{
+		typedef std::variant<glm::vec4, Hazel::Ref<Hazel::Texture2D>> ColourTexture;
+
+		//Colour or texture picked once so drawing never inspects the variant
+		struct DrawCommand
+		{
+			DrawCommand() = default;
+			DrawCommand(const ColourTexture& colour);
+
+			Hazel::Ref<Hazel::Texture2D> Texture;
+			glm::vec4 Tint = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+			void Draw(const glm::vec3& position, const glm::vec2& size) const;
+		};
+	}
+}
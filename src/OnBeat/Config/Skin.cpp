@@ -1,7 +1,15 @@
 #include <OnBeat/Config/Skin.h>
 #include <OnBeat/Util/AppUtil/AppUtil.h>
-#include <Hazel/Renderer/Renderer2D.h>
+#include <OnBeat/Util/Jobs/Jobs.h>
+#include <Hazel/Core/Log.h>
 #include <nlohmann/json.hpp>
+#include <stb_image/stb_image.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
 
 using json = nlohmann::json;
 
@@ -9,6 +17,127 @@ namespace OnBeat
 {
 	namespace Skin
 	{
+		//RGBA pixels decoded by a job, only the GL upload is left for the main thread
+		struct DecodedTexture
+		{
+			int Width = 0;
+			int Height = 0;
+			std::vector<stbi_uc> Pixels;
+		};
+
+		static std::mutex DecodedLock;
+		static std::unordered_map<std::string, DecodedTexture> DecodedTextures;
+
+		static void FindTextures(const json& object, const std::string& path, std::vector<std::string>& files)
+		{
+			if (object.is_object() && object.count("colour") && object["colour"].is_string())
+			{
+				std::string file = path + "/textures/" + std::string(object["colour"]);
+				if (std::find(files.begin(), files.end(), file) == files.end())
+					files.push_back(file);
+			}
+			if (object.is_structured())
+			{
+				for (auto& child : object)
+				{
+					FindTextures(child, path, files);
+				}
+			}
+		}
+
+		//Decode every texture the skin references across the job pool before the quads are built
+		static void DecodeTextures(const json& config, const std::string& path)
+		{
+			std::vector<std::string> files;
+			FindTextures(config, path, files);
+
+			std::vector<JobHandle> jobs;
+			jobs.reserve(files.size());
+			for (auto& file : files)
+			{
+				jobs.push_back(JobSystem::Get().Schedule([file](JobHandle&)
+				{
+					//stb's flip flag is global, rows are flipped here to match Texture2D::Create(path)
+					DecodedTexture texture;
+					int channels;
+					stbi_uc* data = stbi_load(file.c_str(), &texture.Width, &texture.Height, &channels, 4);
+					if (!data)
+						return;
+
+					size_t stride = (size_t)texture.Width * 4;
+					texture.Pixels.resize(stride * texture.Height);
+					for (int row = 0; row < texture.Height; row++)
+					{
+						std::memcpy(texture.Pixels.data() + stride * row, data + stride * (texture.Height - 1 - row), stride);
+					}
+					stbi_image_free(data);
+
+					std::lock_guard<std::mutex> lock(DecodedLock);
+					DecodedTextures[file] = std::move(texture);
+				}));
+			}
+			for (auto& job : jobs)
+			{
+				job.Wait();
+			}
+		}
+
+		//Uses pixels from DecodeTextures when they exist, otherwise reads the file
+		static Hazel::Ref<Hazel::Texture2D> LoadTexture(const std::string& file)
+		{
+			std::lock_guard<std::mutex> lock(DecodedLock);
+			auto it = DecodedTextures.find(file);
+			if (it == DecodedTextures.end())
+				return Hazel::Texture2D::Create(file);
+
+			DecodedTexture& decoded = it->second;
+			Hazel::Ref<Hazel::Texture2D> texture = Hazel::Texture2D::Create(decoded.Width, decoded.Height);
+			texture->SetData(decoded.Pixels.data(), (uint32_t)decoded.Pixels.size());
+			return texture;
+		}
+
+		//Strict parse, the whole string must be a number with an optional unit
+		bool Length::Parse(const std::string& text, Length& length)
+		{
+			const char* begin = text.c_str();
+			char* end = nullptr;
+			float value = std::strtof(begin, &end);
+			if (end == begin)
+			{
+				return false;
+			}
+
+			std::string unit(end);
+			if (unit == "%")
+			{
+				length.Type = Unit::Percent;
+			}
+			else if (unit == "px")
+			{
+				length.Type = Unit::Pixel;
+			}
+			else if (unit == "f" || unit.empty())
+			{
+				length.Type = Unit::World;
+			}
+			else
+			{
+				return false;
+			}
+			length.Value = value;
+			return true;
+		}
+
+		float Length::Resolve(float extent) const
+		{
+			switch (Type)
+			{
+				case Unit::Percent: return Value * extent / 10000;
+				case Unit::Pixel: return Value / 100;
+				default: return Value;
+			}
+		}
+
 		Quad::Quad()
 			:
 			x("0.0f"),
@@ -17,6 +146,7 @@ namespace OnBeat
 			scaleY("1.0f"),
 			Colour(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f))
 		{
+			Compile();
 		}
 
 		//Create quad from json object
@@ -30,12 +160,13 @@ namespace OnBeat
 
 			if (object["colour"].is_string())
 			{
-				Colour = Hazel::Texture2D::Create(texturePath + "/textures/" + std::string(object["colour"]));
+				Colour = LoadTexture(texturePath + "/textures/" + std::string(object["colour"]));
 			}
 			else
 			{
 				Colour = Util::arrayToVec4(object["colour"]);
 			}
+			Compile();
 		}
 
 		Quad::Quad(ColourTexture Colour, const std::string& x, const std::string& y, const std::string& scaleX, const std::string& scaleY)
@@ -46,58 +177,42 @@ namespace OnBeat
 			scaleY(scaleY),
 			Colour(Colour)
 		{
+			Compile();
 		}
 
-		float Quad::getX()
+		//Parse the layout strings, invalid values are reported and left as zero
+		bool Quad::Compile()
 		{
-			return Util::stringSizeToFloat(x, Util::Flag::WIDTH);
-		}
+			Command = DrawCommand(Colour);
 
-		float Quad::getY()
-		{
-			return Util::stringSizeToFloat(y, Util::Flag::HEIGHT);
-		}
-		float Quad::getScaleX()
-		{
-			return Util::stringSizeToFloat(scaleX, Util::Flag::WIDTH);
-		}
-		float Quad::getScaleY()
-		{
-			return Util::stringSizeToFloat(scaleY, Util::Flag::HEIGHT);
-		}
-
-		glm::vec2 Quad::toScaleVec()
-		{
-			return glm::vec2(
-				Util::stringSizeToFloat(scaleX, Util::Flag::WIDTH),
-				Util::stringSizeToFloat(scaleY, Util::Flag::HEIGHT)
-			);
+			bool valid = true;
+			std::pair<const std::string*, Length*> fields[] = {
+				{ &x, &Layout.X },
+				{ &y, &Layout.Y },
+				{ &scaleX, &Layout.ScaleX },
+				{ &scaleY, &Layout.ScaleY }
+			};
+			for (auto& [text, length] : fields)
+			{
+				if (!Length::Parse(*text, *length))
+				{
+					HZ_ERROR("Skin layout error: \"{0}\" is not a valid size", *text);
+					*length = Length();
+					valid = false;
+				}
+			}
+			return valid;
 		}
 
-		glm::vec2 Quad::toPositionVec()
+		void Quad::Resolve(float width, float height)
 		{
-			return glm::vec2(
-				Util::stringSizeToFloat(x, Util::Flag::WIDTH),
-				Util::stringSizeToFloat(y, Util::Flag::HEIGHT)
-			);
+			Position = { Layout.X.Resolve(width), Layout.Y.Resolve(height) };
+			Size = { Layout.ScaleX.Resolve(width), Layout.ScaleY.Resolve(height) };
 		}
 
 		void Quad::draw(float z, float xOffset, float yOffset)
 		{
-			try
-			{
-				glm::vec4 pval = std::get<glm::vec4>(Colour);
-				Hazel::Renderer2D::DrawQuad(
-					{ getX() + xOffset, getY() + yOffset, z },
-					toScaleVec(), pval);
-			}
-			catch (std::bad_variant_access const&)
-			{
-				Hazel::Ref<Hazel::Texture2D> pval = std::get<Hazel::Ref<Hazel::Texture2D>>(Colour);
-				Hazel::Renderer2D::DrawQuad(
-					{ getX() + xOffset, getY() + yOffset, z },
-					toScaleVec(), pval);
-			}
+			Command.Draw({ Position.x + xOffset, Position.y + yOffset, z }, Size);
 		}
 
 		LayerSkin::LayerSkin(Quad BackgroundTexture, glm::vec4 ClearColour)
@@ -114,6 +229,11 @@ namespace OnBeat
 		{
 		}
 
+		void LayerSkin::Resolve(float width, float height)
+		{
+			BackgroundTexture.Resolve(width, height);
+		}
+
 		LoadingSkin::LoadingSkin()
 		{
 		}
@@ -129,6 +249,12 @@ namespace OnBeat
 		{
 		}
 
+		void LoadingSkin::Resolve(float width, float height)
+		{
+			LayerSkin::Resolve(width, height);
+			LoadingAnimation.Resolve(width, height);
+		}
+
 		MusicSkin::MusicSkin()
 		{
 
@@ -153,6 +279,18 @@ namespace OnBeat
 		{
 		}
 
+		HitsoundSkin::HitsoundSkin(const json& object, const std::string& path)
+		{
+			auto sample = [&](const char* key)
+			{
+				std::string name = object.value(key, "");
+				return name.empty() ? name : path + "/sounds/" + name;
+			};
+			Hit = sample("Hit");
+			Miss = sample("Miss");
+			Volume = object.value("Volume", 1.0f);
+		}
+
 		MusicSkin::MusicSkin(const json& object, const std::string& path)
 			:
 			LayerSkin(object, path),
@@ -165,9 +303,40 @@ namespace OnBeat
 			{
 				Columns.push_back(Quad(column, path));
 			}
+			if (object.contains("Hitsounds"))
+			{
+				Hitsounds = HitsoundSkin(object["Hitsounds"], path);
+			}
 			//TODO(Callum): Pass in texturePath from the skin.json not the skin path
 		}
 
+		void MusicSkin::Resolve(float width, float height)
+		{
+			LayerSkin::Resolve(width, height);
+			for (auto& column : Columns)
+			{
+				column.Resolve(width, height);
+			}
+			Beat.Resolve(width, height);
+			BeatArea.Resolve(width, height);
+			BeatZone.Resolve(width, height);
+
+			//Beats keep the texture aspect and fill the gap between two column lines
+			glm::vec2 beatSize = Beat.Size;
+			if (auto texture = std::get_if<Hazel::Ref<Hazel::Texture2D>>(&Beat.Colour))
+			{
+				beatSize = { (*texture)->GetWidth() / 100.0f, (*texture)->GetHeight() / 100.0f };
+			}
+			float aspect = beatSize.x > 0.0f ? beatSize.y / beatSize.x : 0.0f;
+
+			Lanes.clear();
+			for (size_t c = 0; c + 1 < Columns.size(); c++)
+			{
+				float laneWidth = std::abs(Columns[c].Position.x - Columns[c + 1].Position.x);
+				Lanes.push_back({ Columns[c].Position.x + laneWidth / 2, { laneWidth, laneWidth * aspect } });
+			}
+		}
+
 		AppSkin::AppSkin()
 		{
 
@@ -206,8 +375,13 @@ namespace OnBeat
 			SkinName = config["Name"];
 			SkinDirectory = std::filesystem::path(file).parent_path().string();
 
+			DecodeTextures(config, SkinDirectory);
 			LoadingSkin = Skin::LoadingSkin(config["LoadingScreen"], SkinDirectory);
 			MusicSkin = Skin::MusicSkin(config["MusicSkin"], SkinDirectory);
+
+			//Pixels are only needed until every quad has its texture
+			std::lock_guard<std::mutex> lock(DecodedLock);
+			DecodedTextures.clear();
 		}
 	}
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <OnBeat/Config/DrawCommand.h>
 #include <Hazel/Renderer/Texture.h>
 #include <nlohmann/json.hpp>
 #include <glm/glm.hpp>
@@ -8,7 +9,22 @@ namespace OnBeat
 {
 	namespace Skin
 	{
-		typedef std::variant<glm::vec4, Hazel::Ref<Hazel::Texture2D>> ColourTexture;
+		//Skin size such as "10%" of the window, "100px" or world units "0.5f"
+		struct Length
+		{
+			enum class Unit : uint8_t
+			{
+				World,
+				Percent,
+				Pixel
+			};
+
+			float Value = 0.0f;
+			Unit Type = Unit::World;
+
+			static bool Parse(const std::string& text, Length& length);
+			float Resolve(float extent) const;
+		};
 
 		struct Quad
 		{
@@ -20,23 +36,48 @@ namespace OnBeat
 			std::string x, y, scaleX, scaleY;
 			ColourTexture Colour;
 
-			float getX();
-			float getY();
-			float getScaleX();
-			float getScaleY();
+			//Layout compiled from the strings once, then resolved against the window on resize
+			struct
+			{
+				Length X, Y, ScaleX, ScaleY;
+			} Layout;
+			glm::vec2 Position = { 0.0f, 0.0f };
+			glm::vec2 Size = { 1.0f, 1.0f };
+			DrawCommand Command;
 
-			glm::vec2 toScaleVec();
-			glm::vec2 toPositionVec();
+			bool Compile();
+			void Resolve(float width, float height);
+
+			float getX() const { return Position.x; }
+			float getY() const { return Position.y; }
+			float getScaleX() const { return Size.x; }
+			float getScaleY() const { return Size.y; }
+
+			glm::vec2 toScaleVec() const { return Size; }
+			glm::vec2 toPositionVec() const { return Position; }
 
 			void draw(float z = 0.0f, float xOffset = 0.0f, float yOffset = 0.0f);
 		};
 
+		//Gameplay samples from the skin's sounds folder, an empty name plays nothing
+		struct HitsoundSkin
+		{
+			HitsoundSkin() = default;
+			HitsoundSkin(const nlohmann::json& object, const std::string& path);
+
+			std::string Hit;
+			std::string Miss;
+			float Volume = 1.0f;
+		};
+
 		struct LayerSkin
 		{
 			LayerSkin(Quad BackgroundTexture = Quad(), glm::vec4 ClearColour = { 0.08f, 0.08f, 0.08f, 1 });
 			LayerSkin(const nlohmann::json& object, const std::string& path);
 			glm::vec4 ClearColour;
 			Quad BackgroundTexture;
+
+			void Resolve(float width, float height);
 		};
 
 		struct LoadingSkin : LayerSkin
@@ -45,6 +86,8 @@ namespace OnBeat
 			LoadingSkin(Quad LoadingAnimation);
 			LoadingSkin(const nlohmann::json& object, const std::string& path);
 			Quad LoadingAnimation;
+
+			void Resolve(float width, float height);
 		};
 
 		struct MusicSkin : LayerSkin
@@ -66,6 +109,17 @@ namespace OnBeat
 			Quad Beat;
 			Quad BeatArea;
 			Quad BeatZone;
+			HitsoundSkin Hitsounds;
+
+			//Beat placement between each pair of column lines, rebuilt by Resolve
+			struct Lane
+			{
+				float X = 0.0f;
+				glm::vec2 BeatSize = { 0.0f, 0.0f };
+			};
+			std::vector<Lane> Lanes;
+
+			void Resolve(float width, float height);
 		};
 
 		struct AppSkin
@@ -73,8 +127,9 @@ namespace OnBeat
 			AppSkin();
 			AppSkin(const std::string& path);
 
-			LoadingSkin LoadingSkin;
-			MusicSkin MusicSkin;
+			//Qualified, GCC rejects a member that changes what its type name means
+			Skin::LoadingSkin LoadingSkin;
+			Skin::MusicSkin MusicSkin;
 			std::string SkinPath;
 			std::string SkinName;
 			std::string SkinDirectory;
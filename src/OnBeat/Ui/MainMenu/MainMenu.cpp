@@ -27,9 +27,22 @@ namespace OnBeat
 		return;
 	}
 
+	void MainMenu::StartPlaylist(const ul::JSObject& obj, const ul::JSArgs& args)
+	{
+		App::Get().GetLayerStack().SetCallback(BindPostUpdateCallback(&MainMenu::StartPlaylistLayer));
+		return;
+	}
+
+	void MainMenu::StartCalibration(const ul::JSObject& obj, const ul::JSArgs& args)
+	{
+		//Swapping layers has to wait until the layer stack has finished updating
+		App::Get().GetLayerStack().SetCallback([]() { App::Get().StartCalibration(); });
+		return;
+	}
+
 	void MainMenu::ExitGame(const ul::JSObject& obj, const ul::JSArgs& args)
 	{
-		Hazel::Application::Get().Close();
+		App::Get().Close();
 		return;
 	}
 
@@ -118,6 +131,64 @@ namespace OnBeat
 		return (ul::JSValue)ret;
 	}
 
+	ul::JSValue MainMenu::QuerySongs(const ul::JSObject& obj, const ul::JSArgs& args)
+	{
+		if (args.size() != 5)
+		{
+			HZ_WARN("QuerySongs received invalid args of size: {0}", args.size());
+			return ul::JSValue(false);
+		}
+
+		size_t offset = (size_t)std::max(args[0].ToNumber(), 0.0);
+		size_t count = (size_t)std::clamp(args[1].ToNumber(), 0.0, (double)OB_SONG_QUERY_LIMIT);
+		SongSort sort = (SongSort)std::clamp((int)args[2].ToNumber(), 0, (int)SongSort::Path);
+		ul::String filter = args[4].ToString();
+		Songs.Update(sort, args[3].ToBoolean(), filter.utf8().data());
+
+		//Arrays rather than objects and only the window asked for, a page costs the same in any size library
+		ul::JSArray rows;
+		size_t end = std::min(offset + count, Songs.GetCount());
+		for (size_t i = offset; i < end; i++)
+		{
+			const SongEntry& song = Songs.GetSong(i);
+			ul::JSArray row({ ul::JSValue(song.Path.c_str()), ul::JSValue(song.Title.c_str()),
+				ul::JSValue(song.Artist.c_str()), ul::JSValue(song.Album.c_str()), ul::JSValue(song.Duration) });
+			rows.push((ul::JSValue)row);
+		}
+
+		ul::JSObject ret;
+		ret["total"] = (double)Songs.GetCount();
+		ret["offset"] = (double)offset;
+		ret["version"] = (double)Songs.GetVersion();
+		ret["rows"] = (ul::JSValue)rows;
+		return (ul::JSValue)ret;
+	}
+
+	ul::JSValue MainMenu::GetLibraryState(const ul::JSObject& obj, const ul::JSArgs& args)
+	{
+		ul::JSObject ret;
+		ret["version"] = (double)SongLibrary::Get().GetVersion();
+		ret["scanning"] = SongLibrary::Get().GetScanning();
+		return (ul::JSValue)ret;
+	}
+
+	void MainMenu::PlaySong(const ul::JSObject& obj, const ul::JSArgs& args)
+	{
+		if (args.size() != 2)
+		{
+			HZ_WARN("PlaySong received invalid args of size: {0}", args.size());
+			return;
+		}
+
+		ul::String path = args[0].ToString();
+		std::string song = path.utf8().data();
+		if (args[1].ToBoolean())
+			App::Get().GetLayerStack().SetCallback([song]() { App::Get().StartPlaylist(song); });
+		else
+			App::Get().GetLayerStack().SetCallback([song]() { App::Get().StartGame(song); });
+		return;
+	}
+
 	void MainMenu::OnDOMReady(ul::View* caller, uint64_t frame_id,
 		bool is_main_frame, const ul::String& url)
 	{
@@ -131,11 +202,16 @@ namespace OnBeat
 
 		//C callbacks from JS
 		globalObj["StartGame"] = BindJSCallback(&MainMenu::StartGame);
+		globalObj["StartPlaylist"] = BindJSCallback(&MainMenu::StartPlaylist);
+		globalObj["StartCalibration"] = BindJSCallback(&MainMenu::StartCalibration);
 		globalObj["ExitGame"] = BindJSCallback(&MainMenu::ExitGame);
 		globalObj["UpdateSettings"] = BindJSCallback(&MainMenu::UpdateSettings);
 		globalObj["RevertSettings"] = BindJSCallback(&MainMenu::RevertSettings);
 		globalObj["SelectSkin"] = BindJSCallbackWithRetval(&MainMenu::SelectSkin);
 		globalObj["GetHWInfo"] = BindJSCallbackWithRetval(&MainMenu::GetHWInfo);
+		globalObj["QuerySongs"] = BindJSCallbackWithRetval(&MainMenu::QuerySongs);
+		globalObj["GetLibraryState"] = BindJSCallbackWithRetval(&MainMenu::GetLibraryState);
+		globalObj["PlaySong"] = BindJSCallback(&MainMenu::PlaySong);
 
 		//Notify JS Content is loaded
 		if (globalObj["DOMLoaded"].IsFunction())
@@ -152,6 +228,16 @@ namespace OnBeat
 		return;
 	}
 
+	void MainMenu::StartPlaylistLayer()
+	{
+		auto dialog = Hazel::FileDialogs::OpenFile("Supported Files (*.wav, *.mp3)\0*.wav;*.mp3;\0Wav Files (*.wav)\0*.wav\0MP3 Files (*.mp3)\0*.mp3\0");
+		if (dialog.has_value())
+		{
+			App::Get().StartPlaylist(dialog.value());
+		}
+		return;
+	}
+
 	void MainMenu::DiscordPresence()
 	{
 		activity.SetState("Idle");
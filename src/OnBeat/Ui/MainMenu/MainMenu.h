@@ -1,6 +1,10 @@
 #pragma once
 #include <OnBeat/Util/Template/Menu.h>
 #include <OnBeat/Util/JS/JS.h>
+#include <OnBeat/Util/SongLibrary/SongView/SongView.h>
+
+//Most rows one QuerySongs call hands to JS
+#define OB_SONG_QUERY_LIMIT 256
 
 namespace OnBeat
 {
@@ -12,13 +16,22 @@ namespace OnBeat
 
 			//JS Callbacks to C
 			void StartGame(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
+			void StartPlaylist(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
+			void StartCalibration(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
 			void ExitGame(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
 			void UpdateSettings(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
 			void RevertSettings(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
 			ultralight::JSValue SelectSkin(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
 			ultralight::JSValue GetHWInfo(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
+			//(offset, count, sort, descending, filter), rows are [path, title, artist, album, duration] arrays
+			ultralight::JSValue QuerySongs(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
+			//Polled by the song list to notice a rescan finishing
+			ultralight::JSValue GetLibraryState(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
+			//(path, folder), folder plays the rest of the song's folder after it
+			void PlaySong(const ultralight::JSObject& obj, const ultralight::JSArgs& args);
 
 			void StartMusicLayer();
+			void StartPlaylistLayer();
 
 			void UpdateMenu(Hazel::Timestep ms) override;
 
@@ -30,5 +43,7 @@ namespace OnBeat
 		private:
 			void DiscordPresence();
 
+			SongView Songs;
+
 	};
 }
\ No newline at end of file
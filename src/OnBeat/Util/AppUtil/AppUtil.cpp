@@ -14,43 +14,6 @@ namespace OnBeat
 			return glm::vec4(object[0], object[1], object[2], object[3]);
 		}
 
-		//Convert string to Hazel float value
-		float stringSizeToFloat(std::string val, Flag flag)
-		{
-			std::string type = val.substr(val.size() - 1, val.size());
-			float n = (float)std::atof(val.c_str());
-			if (type == "%")
-			{
-				float scale = 1600.0f;
-				if (flag == Flag::HEIGHT)
-				{
-					scale = (float)Hazel::Application::Get().GetWindow().GetHeight();
-				}
-				if (flag == Flag::WIDTH)
-				{
-					scale = (float)Hazel::Application::Get().GetWindow().GetWidth();
-				}
-				return n * scale / 10000;
-			}
-			else if (type == "px")
-			{
-				float scale;
-				if (flag == Flag::HEIGHT)
-				{
-					scale = (float)Hazel::Application::Get().GetWindow().GetHeight();
-				}
-				if (flag == Flag::WIDTH)
-				{
-					scale = (float)Hazel::Application::Get().GetWindow().GetWidth();
-				}
-				return n / 100;
-			}
-			else
-			{
-				return n;
-			}
-		}
-
 		//Check for file and create paths if makePath
 		bool checkPath(std::string file, bool makePath)
 		{
@@ -68,6 +31,22 @@ namespace OnBeat
 			return true;
 		}
 
+		std::vector<std::string> splitString(const std::string& text, char separator)
+		{
+			std::vector<std::string> parts;
+			size_t start = 0;
+			while (start <= text.size())
+			{
+				size_t end = text.find(separator, start);
+				if (end == std::string::npos)
+					end = text.size();
+				if (end > start)
+					parts.push_back(text.substr(start, end - start));
+				start = end + 1;
+			}
+			return parts;
+		}
+
 		using namespace ultralight;
 		using namespace ultralight::KeyCodes;
 
@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 #include <AppCore/JSHelpers.h>
 #include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
 
 typedef struct GLFWcursor GLFWcursor;
 
@@ -10,17 +12,11 @@ namespace OnBeat
 {
 	namespace Util
 	{
-		enum class Flag : uint8_t
-		{
-			WIDTH = 1,
-			HEIGHT = 2,
-		};
-
 		glm::vec4 arrayToVec4(nlohmann::json object);
 
-		float stringSizeToFloat(std::string val, Flag flag);
-
 		bool checkPath(std::string file, bool makePath);
+		//Empty parts are dropped
+		std::vector<std::string> splitString(const std::string& text, char separator);
 
 		int hazelKeyCodeToUl(int key);
 		int ulKeyCodeToHazel(int key);
@@ -0,0 +1,66 @@
+#include <OnBeat/Util/AudioPlayer/AudioClock/AudioClock.h>
+#include <algorithm>
+#include <cmath>
+
+namespace OnBeat
+{
+	AudioClock::AudioClock(double snapThreshold, double correction)
+		: Block(snapThreshold), SnapThreshold(snapThreshold), Correction(correction)
+	{
+	}
+
+	void AudioClock::Reset(double time)
+	{
+		Time = time;
+		LastAudioTime = -1.0;
+		Block = SnapThreshold;
+		Stats = Statistics();
+	}
+
+	double AudioClock::Update(double audioTime, double delta, bool playing)
+	{
+		//Paused or not started, hold on the audio position
+		if (!playing)
+		{
+			Time = audioTime;
+			LastAudioTime = audioTime;
+			return Time;
+		}
+
+		double previous = Time;
+		Time += delta;
+
+		//Only correct when the mixer has moved, repeated readings are stale
+		if (audioTime != LastAudioTime)
+		{
+			//Smallest step seen is the mixer block length
+			double step = audioTime - LastAudioTime;
+			if (LastAudioTime >= 0.0 && step > 0.0)
+			{
+				Block = std::min(Block, step);
+			}
+			LastAudioTime = audioTime;
+
+			//The reading is the start of a block that began within the last frame or block
+			double error = audioTime + std::min(delta, Block) / 2 - Time;
+			Stats.Error = error;
+			Stats.Updates++;
+			if (std::abs(error) > SnapThreshold)
+			{
+				//Seek, hitch or start up latency
+				Time = audioTime;
+				Stats.Snaps++;
+				Stats.Drift = 0.0;
+				return Time;
+			}
+
+			Time += error * Correction;
+			Stats.Drift += (error - Stats.Drift) * 0.01;
+			Stats.MaxDrift = std::max(Stats.MaxDrift, std::abs(Stats.Drift));
+		}
+
+		//Small corrections never move notes backwards
+		Time = std::max(Time, previous);
+		return Time;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+namespace OnBeat
+{
+	//Smooth song time that follows the audio position
+	//The audio position only moves once per mixer block so it is interpolated with the frame clock
+	class AudioClock
+	{
+		public:
+			struct Statistics
+			{
+				//Seconds, positive when the clock is behind the audio
+				double Error = 0.0;
+				//Smoothed error, the drift notes would show against the music
+				double Drift = 0.0;
+				double MaxDrift = 0.0;
+				uint64_t Snaps = 0;
+				uint64_t Updates = 0;
+			};
+
+			AudioClock(double snapThreshold = 0.05, double correction = 0.1);
+
+			void Reset(double time = 0.0);
+
+			//Advance by the frame delta and pull towards a new audio reading, returns the song time
+			double Update(double audioTime, double delta, bool playing);
+
+			double GetTime() const { return Time; }
+			const Statistics& GetStats() const { return Stats; }
+
+		private:
+			double Time = 0.0;
+			double LastAudioTime = -1.0;
+			double Block;
+
+			double SnapThreshold;
+			double Correction;
+
+			Statistics Stats;
+	};
+}
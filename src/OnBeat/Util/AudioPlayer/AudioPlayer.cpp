@@ -2,8 +2,13 @@
 #include <FMOD/fmod_errors.h>
 #include <FMOD/fmod_output.h>
 #include <OnBeat/Util/AudioPlayer/AudioPlayer.h>
+#include <OnBeat/Util/Input/Input.h>
 #include <string>
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 
 #define AP_LOG(x) std::cout << "[Audio Player] " << x << std::endl;
 #define AP_WARN(x) std::cerr << "[Audio Player - Warning] " << x << std::endl;
@@ -24,176 +29,797 @@ namespace OnBeat
 	}
 
 
+	static FMOD_OUTPUTTYPE OutputType(AudioOutput output)
+	{
+		switch (output)
+		{
+			case AudioOutput::NoSound:
+				return FMOD_OUTPUTTYPE_NOSOUND_NRT;
+			case AudioOutput::WavWriter:
+				return FMOD_OUTPUTTYPE_WAVWRITER_NRT;
+			default:
+				return FMOD_OUTPUTTYPE_AUTODETECT;
+		}
+	}
+
 	int AudioPlayer::PauseAudio(bool pause)
 	{
 		//Set paused state of audio to passed var
-		if (FMOD_ERRCHECK(
-			channel->setPaused(pause)
-		))
+		Command command;
+		command.Action = Command::Type::Pause;
+		command.Value = pause ? 1.0f : 0.0f;
+		return Queue(command);
+	}
+
+	int AudioPlayer::PlayAudio()
+	{
+		Command command;
+		command.Action = Command::Type::Play;
+		if (!Queue(command))
 		{
-			system->update();
 			return 0;
 		}
-		else
+		Issued.fetch_add(1, std::memory_order_acq_rel);
+		return 1;
+	}
+
+	int AudioPlayer::LoadAudio(const std::string& audioLocation)
+	{
+		//Loads audio into FMOD player
+		if (audioLocation.empty())
+		{
+			AP_WARN("No audio file given\n");
+			return 0;
+		}
+
+		Command command;
+		command.Action = Command::Type::Load;
+		if (!SetFile(command, audioLocation) || !Queue(command))
 		{
-			return 1;
+			return 0;
 		}
+		Issued.fetch_add(1, std::memory_order_acq_rel);
+		return 1;
 	}
 
-	int AudioPlayer::PlayAudio()
+	int AudioPlayer::ReleaseSound(bool resident)
 	{
-		//Reset audio if already playing
-		//Plays audio from AudioFile
-		//Assigns channel handle
-		if (playing)
+		Command command;
+		command.Action = Command::Type::Release;
+		command.Enabled = resident;
+		if (!Queue(command))
 		{
-			if (!FMOD_ERRCHECK(channel->setPosition(0, FMOD_TIMEUNIT_MS)))
+			return 0;
+		}
+		Issued.fetch_add(1, std::memory_order_acq_rel);
+		return 1;
+	}
+
+	int AudioPlayer::EvictSound(const std::string& file)
+	{
+		Command command;
+		command.Action = Command::Type::Evict;
+		return SetFile(command, file) && Queue(command);
+	}
+
+	int AudioPlayer::PreloadSound(const std::string& file)
+	{
+		Command command;
+		command.Action = Command::Type::Preload;
+		return SetFile(command, file) && Queue(command);
+	}
+
+	bool AudioPlayer::SetVolume(float volume)
+	{
+		Command command;
+		command.Action = Command::Type::Volume;
+		command.Value = volume;
+		if (!Queue(command))
+		{
+			return false;
+		}
+		this->volume.store(volume, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool AudioPlayer::SetOutput(unsigned int bufferLength, int bufferCount)
+	{
+		Command command;
+		command.Action = Command::Type::Output;
+		command.BufferLength = bufferLength;
+		command.BufferCount = bufferCount;
+		return Queue(command);
+	}
+
+	bool AudioPlayer::SetHitsounds(const HitsoundFiles& files, float volume)
+	{
+		for (size_t s = 0; s < files.size(); s++)
+		{
+			Command sample;
+			sample.Action = Command::Type::Hitsound;
+			sample.Sample = (Hitsound)s;
+			if (!SetFile(sample, files[s]) || !Queue(sample))
 			{
-				AP_WARN("Error resetting position\n");
-				return 0;
+				return false;
 			}
-			return 1;
 		}
 
+		Command command;
+		command.Action = Command::Type::Hitsounds;
+		command.Value = volume;
+		return Queue(command);
+	}
 
-		if (!FMOD_ERRCHECK(
-			system->playSound(
-				sound,
-				0,
-				false,
-				&channel
-			)))
+	bool AudioPlayer::SetMetronome(double interval, bool audible)
+	{
+		Command command;
+		command.Action = Command::Type::Metronome;
+		command.Value = (float)interval;
+		command.Enabled = audible;
+		return Queue(command);
+	}
+
+	double AudioPlayer::GetMetronomeTime()
+	{
+		return Published.Read().MetronomeTime;
+	}
+
+	bool AudioPlayer::Advance(unsigned int blocks)
+	{
+		if (!GetHeadless() || !Running.load(std::memory_order_acquire))
 		{
-			AP_WARN(std::string("Error playing song " + std::string(AudioFile) + "\n").c_str());
-			return 0;
+			return false;
 		}
 
-		channel->setChannelGroup(ChannelGroup);
-		system->update();
-		return 1;
+		uint64_t target = BlocksRequested.fetch_add(blocks, std::memory_order_acq_rel) + blocks;
+		while (BlocksMixed.load(std::memory_order_acquire) < target)
+		{
+			std::this_thread::yield();
+		}
+		return true;
+	}
 
+	float AudioPlayer::GetVolume()
+	{
+		return (float)volume.load(std::memory_order_relaxed);
+	}
 
+	bool AudioPlayer::GetPlaying()
+	{
+		//Read the queued count first, a command carried out after it only makes the snapshot newer
+		uint64_t issued = Issued.load(std::memory_order_acquire);
+		State state = Published.Read();
+		return state.Playing && state.Applied >= issued;
 	}
 
-	int AudioPlayer::LoadAudio(const std::string& audioLocation)
+	unsigned int AudioPlayer::GetLength()
 	{
-		//Loads audio into FMOD player
-		if (audioLocation.empty() && AudioFile.empty())
+		return Published.Read().Length;
+	}
+
+	size_t AudioPlayer::GetSoundBytes()
+	{
+		return Published.Read().SoundBytes;
+	}
+
+	bool AudioPlayer::GetLoaded()
+	{
+		uint64_t issued = Issued.load(std::memory_order_acquire);
+		State state = Published.Read();
+		return state.Loaded && state.Applied >= issued;
+	}
+
+	unsigned int AudioPlayer::GetCurrentPos()
+	{
+		//Returns the current position in milliseconds
+		if (!GetPlaying())
 		{
-			AP_WARN("No audio file given\n");
 			return 0;
 		}
+		return (unsigned int)(GetPosition() * 1000.0);
+	}
 
-		AudioFile = audioLocation;
-		FMOD_ERRCHECK(system->createSound(
-			AudioFile.c_str(),
-			FMOD_DEFAULT,
-			0,
-			&sound
-		));
+	double AudioPlayer::GetPosition()
+	{
+		return Published.Read().Position;
+	}
 
-		AP_LOG(std::string(std::string(AudioFile) + " loaded...\n").c_str());
-		playing = false;
+	uint64_t AudioPlayer::GetPositionSamples()
+	{
+		return Published.Read().PositionSamples;
+	}
 
-		loaded = true;
+	uint64_t AudioPlayer::GetDSPClock()
+	{
+		return Published.Read().DSPClock;
+	}
 
-		return 1;
+	int AudioPlayer::GetOutputRate()
+	{
+		return Published.Read().Rate;
+	}
 
+	unsigned int AudioPlayer::GetBlockLength()
+	{
+		return Published.Read().Block;
 	}
 
-	int AudioPlayer::ReleaseSound()
+	double AudioPlayer::GetOutputLatency()
 	{
-		sound->release();
-		return 1;
+		return Published.Read().Latency;
 	}
 
-	bool AudioPlayer::SetVolume(float volume)
+	bool AudioPlayer::GetPaused()
 	{
-		if (!FMOD_ERRCHECK(ChannelGroup->setVolume(volume)))
+		return Published.Read().Paused;
+	}
+
+	bool AudioPlayer::SetFile(Command& command, const std::string& file)
+	{
+		if (file.size() >= sizeof(command.File))
 		{
+			AP_WARN("Path too long for an audio request: " << file);
 			return false;
 		}
-		else
+		std::memcpy(command.File, file.c_str(), file.size() + 1);
+		return true;
+	}
+
+	bool AudioPlayer::Queue(const Command& command)
+	{
+		if (!Commands.Push(command))
 		{
-			this->volume = volume;
-			return true;
+			AP_WARN("Command queue full, request dropped");
+			return false;
 		}
+		return true;
 	}
 
-	float AudioPlayer::GetVolume()
+	void AudioPlayer::Service()
 	{
-		return (float)volume;
+		auto period = std::chrono::nanoseconds(1000000000LL / OB_AUDIO_SERVICE_RATE);
+		auto next = std::chrono::steady_clock::now();
+		Command command;
+
+		while (Running.load(std::memory_order_acquire))
+		{
+			//Read before draining so commands queued ahead of an Advance run before its blocks
+			uint64_t requested = BlocksRequested.load(std::memory_order_acquire);
+			while (Commands.Pop(command))
+			{
+				Execute(command);
+			}
+
+			if (!Initialised)
+			{
+				//Nothing mixes without an output, blocks asked for are let through so Advance returns
+				BlocksMixed.store(requested, std::memory_order_release);
+			}
+			else
+			{
+				ServiceOpening();
+				Effects.Service(system, BufferLength, OutputRate, Current.Latency);
+				ServiceMetronome();
+
+				if (GetHeadless())
+				{
+					//Non realtime outputs mix one block per update so the caller owns the clock
+					uint64_t mixed = BlocksMixed.load(std::memory_order_relaxed);
+					for (; mixed < requested; mixed++)
+					{
+						FMOD_ERRCHECK(system->update());
+						MixedSamples += BufferLength;
+					}
+					int64_t seconds = (int64_t)(MixedSamples / OutputRate);
+					int64_t remainder = (int64_t)(MixedSamples % OutputRate);
+					MixedTime.store(seconds * 1000000000LL + remainder * 1000000000LL / OutputRate, std::memory_order_release);
+					Publish();
+					BlocksMixed.store(mixed, std::memory_order_release);
+				}
+				else
+				{
+					FMOD_ERRCHECK(system->update());
+					Publish();
+				}
+			}
+
+			next += period;
+			std::this_thread::sleep_until(next);
+
+			//Resync after a long stall instead of running a burst of updates
+			auto now = std::chrono::steady_clock::now();
+			if (now - next > period * 10)
+			{
+				next = now;
+			}
+		}
+
+		//Finish anything queued before shutdown, a release may be waiting
+		while (Commands.Pop(command))
+		{
+			Execute(command);
+		}
 	}
 
-	const std::string& AudioPlayer::GetAudioFile()
+	void AudioPlayer::Execute(const Command& command)
 	{
-		return AudioFile;
+		//Without a system only a new output is tried, requests are still counted so GetLoaded settles
+		if (!Initialised && command.Action != Command::Type::Output && command.Action != Command::Type::Hitsound)
+		{
+			if (command.Action == Command::Type::Load || command.Action == Command::Type::Play || command.Action == Command::Type::Release)
+			{
+				Current.Applied++;
+				Published.Publish(Current);
+			}
+			else if (command.Action == Command::Type::Hitsounds)
+			{
+				//Decoded once a restart succeeds
+				Effects.Files = PendingHitsounds;
+				Effects.Volume = command.Value;
+			}
+			return;
+		}
+
+		switch (command.Action)
+		{
+			case Command::Type::Load:
+				Load(command.File);
+				Current.Applied++;
+				break;
+			case Command::Type::Play:
+				Play();
+				Current.Applied++;
+				break;
+			case Command::Type::Pause:
+				Pause(command.Value != 0.0f);
+				break;
+			case Command::Type::Volume:
+				FMOD_ERRCHECK(ChannelGroup->setVolume(command.Value));
+				break;
+			case Command::Type::Release:
+				Unload(command.Enabled);
+				Current.Applied++;
+				break;
+			case Command::Type::Evict:
+			{
+				auto it = Resident.find(command.File);
+				if (it != Resident.end())
+				{
+					it->second->release();
+					Resident.erase(it);
+				}
+				break;
+			}
+			case Command::Type::Preload:
+			{
+				if (LoadedFile == command.File || Resident.count(command.File))
+					break;
+
+				//FMOD decodes a non-blocking sound on its own thread so the service loop keeps its rate
+				FMOD::Sound* preload = nullptr;
+				if (FMOD_ERRCHECK(system->createSound(command.File, FMOD_DEFAULT | FMOD_NONBLOCKING, 0, &preload)))
+				{
+					Resident[command.File] = preload;
+				}
+				break;
+			}
+			case Command::Type::Output:
+				Reconfigure(command.BufferLength, command.BufferCount);
+				break;
+			case Command::Type::Hitsound:
+				PendingHitsounds[(size_t)command.Sample] = command.File;
+				break;
+			case Command::Type::Hitsounds:
+				Effects.Load(system, ChannelGroup, PendingHitsounds, command.Value);
+				break;
+			case Command::Type::Metronome:
+				//Muting a running metronome keeps its clock
+				if (command.Value > 0.0f && command.Value == MetronomeInterval)
+				{
+					MetronomeAudible = command.Enabled;
+				}
+				else
+				{
+					StartMetronome(command.Value, command.Enabled);
+				}
+				break;
+		}
 	}
 
-	bool AudioPlayer::GetPlaying()
+	void AudioPlayer::Publish()
+	{
+		bool isPlaying = false;
+		bool isPaused = true;
+
+		//A finished channel is an invalid handle so keep the last position quietly
+		if (channel && channel->isPlaying(&isPlaying) == FMOD_OK && isPlaying)
+		{
+			channel->getPaused(&isPaused);
+			int64_t samples = GetSamples();
+			Current.PositionSamples = (uint64_t)samples;
+			Current.Position = samples / (double)OutputRate;
+			Current.DSPClock = (uint64_t)GetMixerClock();
+		}
+
+		Current.Paused = !isPlaying || isPaused;
+		Current.Playing = isPlaying;
+		Published.Publish(Current);
+	}
+
+	void AudioPlayer::Load(const std::string& file)
 	{
-		if (!FMOD_ERRCHECK(channel->isPlaying(&playing)))
+		//Replaying the loaded song only has to rewind it
+		if (sound && file == LoadedFile)
 		{
-			return playing;
+			if (channel)
+			{
+				channel->stop();
+				channel = nullptr;
+			}
+			if (Opening)
+				return;
 		}
 		else
 		{
+			Unload(false);
+
+			auto resident = Resident.find(file);
+			if (resident != Resident.end())
+			{
+				sound = resident->second;
+				Resident.erase(resident);
+				LoadedFile = file;
+
+				//A preload can still be decoding when its song is reached early, later updates finish the load
+				Opening = true;
+				ServiceOpening();
+				return;
+			}
+
+			if (!Open(file))
+				return;
+		}
+		LoadedFile = file;
+		FinishLoad();
+	}
+
+	bool AudioPlayer::Open(const std::string& file)
+	{
+		if (!FMOD_ERRCHECK(system->createSound(
+			file.c_str(),
+			FMOD_DEFAULT,
+			0,
+			&sound
+		)))
+		{
+			AP_WARN(std::string("Error loading song " + file + "\n").c_str());
+			sound = nullptr;
 			return false;
 		}
+		return true;
 	}
 
-	unsigned int AudioPlayer::GetLength()
+	void AudioPlayer::ServiceOpening()
 	{
-		if (!FMOD_ERRCHECK(sound->getLength(&length, FMOD_TIMEUNIT_MS)))
+		if (!Opening)
+			return;
+
+		FMOD_OPENSTATE state = FMOD_OPENSTATE_ERROR;
+		sound->getOpenState(&state, nullptr, nullptr, nullptr);
+		if (state != FMOD_OPENSTATE_READY && state != FMOD_OPENSTATE_ERROR)
+			return;
+
+		Opening = false;
+		if (state == FMOD_OPENSTATE_ERROR)
 		{
-			return length;
+			//The preload failed, open it again the blocking way to report why
+			sound->release();
+			sound = nullptr;
+			if (!Open(LoadedFile))
+			{
+				LoadedFile.clear();
+				PendingPlay = false;
+				return;
+			}
 		}
-		else
+
+		FinishLoad();
+		if (PendingPlay)
 		{
-			return 0;
+			PendingPlay = false;
+			Play();
 		}
 	}
 
-	bool AudioPlayer::GetLoaded()
+	void AudioPlayer::FinishLoad()
 	{
-		return loaded;
+		FMOD_ERRCHECK(sound->getDefaults(&frequency, nullptr));
+
+		unsigned int ms = 0, bytes = 0;
+		FMOD_ERRCHECK(sound->getLength(&ms, FMOD_TIMEUNIT_MS));
+		FMOD_ERRCHECK(sound->getLength(&bytes, FMOD_TIMEUNIT_PCMBYTES));
+		Current.Length = ms;
+		Current.SoundBytes = bytes;
+		Current.Position = 0.0;
+		Current.PositionSamples = 0;
+
+		AP_LOG(std::string(LoadedFile + " loaded...\n").c_str());
+		Current.Loaded = true;
 	}
 
-	unsigned int AudioPlayer::GetCurrentPos()
+	void AudioPlayer::Unload(bool resident)
 	{
-		//Returns the current position in milliseconds
-		if (!FMOD_ERRCHECK(channel->isPlaying(&playing)))
+		//Releasing a sound that is still opening stalls until it finishes, a resident one is kept instead
+		Opening = false;
+		PendingPlay = false;
+		if (channel)
 		{
-			return 0;
+			channel->stop();
+			channel = nullptr;
 		}
-		else
+		if (sound)
 		{
-			if (!FMOD_ERRCHECK(channel->getPosition(&time, FMOD_TIMEUNIT_MS)))
+			if (resident && !LoadedFile.empty())
 			{
-				return time;
+				FMOD::Sound*& kept = Resident[LoadedFile];
+				if (kept && kept != sound)
+					kept->release();
+				kept = sound;
 			}
 			else
 			{
-				return 0;
+				sound->release();
 			}
+			sound = nullptr;
 		}
+		LoadedFile.clear();
+		Current.SoundBytes = 0;
+		Current.Loaded = false;
 	}
 
-	AudioPlayer::AudioPlayer(const std::string& audioLocation)
+	void AudioPlayer::Play()
 	{
-		//Initialises the FMOD system
-		AudioFile = audioLocation;
+		//Reset audio if already playing
+		//Plays audio from the loaded sound
+		//Assigns channel handle
+		if (Opening)
+		{
+			PendingPlay = true;
+			return;
+		}
+
+		bool isPlaying = false;
+		if (channel && channel->isPlaying(&isPlaying) == FMOD_OK && isPlaying)
+		{
+			if (!FMOD_ERRCHECK(channel->setPosition(0, FMOD_TIMEUNIT_MS)))
+			{
+				AP_WARN("Error resetting position\n");
+			}
+			StartClock = GetMixerClock();
+			PausedSamples = 0;
+			return;
+		}
+
+		Start(0);
+	}
+
+	void AudioPlayer::Start(int64_t offset)
+	{
+		//Starts paused so the channel can be scheduled on a block boundary and the start clock is exact
+		if (!sound || !FMOD_ERRCHECK(
+			system->playSound(
+				sound,
+				ChannelGroup,
+				true,
+				&channel
+			)))
+		{
+			AP_WARN(std::string("Error playing song " + LoadedFile + "\n").c_str());
+			channel = nullptr;
+			return;
+		}
+
+		if (offset > 0)
+		{
+			FMOD_ERRCHECK(channel->setPosition((unsigned int)(offset * (double)frequency / OutputRate), FMOD_TIMEUNIT_PCM));
+		}
+
+		int64_t start = GetMixerClock() + BufferLength;
+		FMOD_ERRCHECK(channel->setDelay((unsigned long long)start, 0, false));
+		FMOD_ERRCHECK(channel->setPaused(false));
+
+		StartClock = start - offset;
+		PausedSamples = 0;
+		ChannelPaused = false;
+	}
+
+	void AudioPlayer::Pause(bool pause)
+	{
+		if (!channel || pause == ChannelPaused)
+		{
+			return;
+		}
+		if (!FMOD_ERRCHECK(channel->setPaused(pause)))
+		{
+			return;
+		}
+
+		//Time spent paused is taken off the song position
+		int64_t clock = GetMixerClock();
+		if (pause)
+		{
+			PauseClock = clock;
+		}
+		else
+		{
+			PausedSamples += clock - PauseClock;
+		}
+		ChannelPaused = pause;
+	}
+
+	void AudioPlayer::StartMetronome(double interval, bool audible)
+	{
+		//The first click is a block out so it is never scheduled in the past
+		MetronomeInterval = interval;
+		MetronomeAudible = audible;
+		MetronomeStart = GetMixerClock() + BufferLength;
+		MetronomeClicks = 0;
+		Current.MetronomeTime = 0.0;
+	}
+
+	void AudioPlayer::ServiceMetronome()
+	{
+		if (MetronomeInterval <= 0.0)
+		{
+			return;
+		}
+
+		//Clicks are scheduled a couple of blocks ahead on the sample they fall on
+		int64_t clock = GetMixerClock();
+		double period = MetronomeInterval * OutputRate;
+		for (;;)
+		{
+			int64_t click = MetronomeStart + (int64_t)std::llround(MetronomeClicks * period);
+			if (click >= clock + (int64_t)BufferLength * 2)
+				break;
+
+			if (MetronomeAudible && click >= clock)
+			{
+				Effects.Play(system, Hitsound::Hit, (unsigned long long)click);
+			}
+			MetronomeClicks++;
+		}
+		Current.MetronomeTime = (clock - MetronomeStart) / (double)OutputRate;
+	}
+
+	int64_t AudioPlayer::GetMixerClock()
+	{
+		//Channel delays are scheduled against the clock of the group they play in
+		unsigned long long clock = 0;
+		if (!ChannelGroup || ChannelGroup->getDSPClock(&clock, nullptr) != FMOD_OK)
+		{
+			return 0;
+		}
+		return (int64_t)clock;
+	}
 
+	int64_t AudioPlayer::GetSamples()
+	{
+		int64_t clock = ChannelPaused ? PauseClock : GetMixerClock();
+		return std::max<int64_t>(clock - StartClock - PausedSamples, 0);
+	}
+
+	bool AudioPlayer::Initialise(unsigned int bufferLength, int bufferCount)
+	{
+		result = system->setOutput(OutputType(Output));
+		if (!FMOD_ERRCHECK(result)) return false;
+
+		result = system->setDSPBufferSize(bufferLength, bufferCount);
+		if (!FMOD_ERRCHECK(result)) return false;
+
+		//Room for the song and every hitsound voice, the wav writer takes its file name as driver data
+		void* driverData = Output == AudioOutput::WavWriter && !OutputFile.empty() ? (void*)OutputFile.c_str() : nullptr;
+		result = system->init(32 + OB_HITSOUND_VOICES, FMOD_INIT_NORMAL, driverData);
+		if (!FMOD_ERRCHECK(result)) return false;
+
+		result = system->createChannelGroup("AudioPlayer", &ChannelGroup);
+		if (!FMOD_ERRCHECK(result)) return false;
+		FMOD_ERRCHECK(ChannelGroup->setVolume((float)volume.load(std::memory_order_relaxed)));
+
+		//The output can round the request, report what was actually used
+		FMOD_ERRCHECK(system->getDSPBufferSize(&BufferLength, &BufferCount));
+		FMOD_ERRCHECK(system->getSoftwareFormat(&OutputRate, nullptr, nullptr));
+		//Headless blocks are finished as soon as they are mixed
+		double seconds = GetHeadless() ? 0.0 : (double)BufferLength * BufferCount / OutputRate;
+		Current.Rate = OutputRate;
+		Current.Block = BufferLength;
+		Current.Latency = seconds;
+		Published.Publish(Current);
+
+		AP_LOG("Output " << OutputRate << "Hz, " << BufferCount << " x " << BufferLength
+			<< " sample buffers, " << seconds * 1000.0 << "ms latency");
+		return true;
+	}
+
+	void AudioPlayer::Reconfigure(unsigned int bufferLength, int bufferCount)
+	{
+		if (!bufferLength)
+		{
+			bufferLength = DefaultLength;
+			bufferCount = DefaultCount;
+		}
+		if (Initialised && bufferLength == BufferLength && bufferCount == BufferCount)
+		{
+			return;
+		}
+
+		//Buffer sizes are fixed once FMOD is initialised so restart it and pick the song up where it was
+		bool isPlaying = false;
+		bool resume = channel && channel->isPlaying(&isPlaying) == FMOD_OK && isPlaying;
+		bool wasPaused = ChannelPaused;
+		int64_t samples = GetSamples();
+		double seconds = samples / (double)OutputRate;
+		std::string file = LoadedFile;
+
+		//Sounds belong to the system being closed, resident ones are decoded again on their next load
+		Unload(false);
+		for (auto& [name, resident] : Resident)
+		{
+			resident->release();
+		}
+		Resident.clear();
+		Effects.Release();
+		if (ChannelGroup)
+		{
+			ChannelGroup->release();
+			ChannelGroup = nullptr;
+		}
+		FMOD_ERRCHECK(system->close());
+
+		Initialised = Initialise(bufferLength, bufferCount);
+		if (!Initialised)
+		{
+			AP_WARN("Could not restart output, audio disabled until settings change");
+			Current.Loaded = false;
+			Current.Playing = false;
+			Current.Paused = true;
+			Published.Publish(Current);
+			return;
+		}
+
+		Effects.Load(system, ChannelGroup, Effects.Files, Effects.Volume);
+		StartMetronome(MetronomeInterval, MetronomeAudible);
+		if (!file.empty())
+		{
+			Load(file);
+		}
+		if (resume)
+		{
+			Start((int64_t)(seconds * OutputRate));
+			Pause(wasPaused);
+		}
+	}
+
+	AudioPlayer::AudioPlayer(const std::string& audioLocation, AudioOutput output, const std::string& outputFile)
+		: Output(output), OutputFile(outputFile)
+	{
+		//Initialises the FMOD system
 		sound = nullptr;
 
 		result = FMOD::System_Create(&system);
 		if (!FMOD_ERRCHECK(result)) return;
 
-		result = system->init(32, FMOD_INIT_NORMAL, 0);
-		if (!FMOD_ERRCHECK(result)) return;
+		//Before init this is the buffer FMOD would pick for the platform
+		FMOD_ERRCHECK(system->getDSPBufferSize(&DefaultLength, &DefaultCount));
+		if (!Initialise(DefaultLength, DefaultCount)) return;
 
-		result = system->createChannelGroup("AudioPlayer", &ChannelGroup);
-		if (!FMOD_ERRCHECK(result)) return;
+		Initialised = true;
+		Running = true;
+		ServiceThread = std::thread(&AudioPlayer::Service, this);
+		if (GetHeadless())
+		{
+			Input::SetClock(&MixedTime);
+		}
 
 		if (!audioLocation.empty())
 		{
@@ -207,8 +833,18 @@ namespace OnBeat
 	{
 		//Stop audio processing
 		ReleaseSound();
-		delete channel;
-		delete sound;
-		delete channel;
+		Running = false;
+		if (ServiceThread.joinable())
+		{
+			ServiceThread.join();
+		}
+		if (GetHeadless())
+		{
+			Input::SetClock(nullptr);
+		}
+		if (system)
+		{
+			system->release();
+		}
 	}
 }
\ No newline at end of file
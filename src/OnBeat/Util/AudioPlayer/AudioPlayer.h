@@ -1,47 +1,202 @@
 #pragma once
 #include <FMOD/fmod.hpp>
+#include <OnBeat/Util/AudioPlayer/Hitsounds/Hitsounds.h>
+#include <OnBeat/Util/Queue/MPSCQueue.h>
+#include <OnBeat/Util/Queue/SeqLock.h>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+#define OB_AUDIO_SERVICE_RATE 1000
+//Longest song path in bytes a request can carry
+#define OB_AUDIO_PATH_LENGTH 1024
 
 namespace OnBeat
 {
 
 	int FMOD_ERRCHECK(FMOD_RESULT r);
 
+	//Where mixed audio goes, the headless outputs only mix when Advance is called
+	enum class AudioOutput
+	{
+		Device,
+		NoSound,
+		WavWriter
+	};
+
+	//FMOD is only touched from the service thread, requests are queued and state is published as one snapshot
 	class AudioPlayer
 	{
 		public:
-			AudioPlayer(const std::string& audioFile = "");
+			//outputFile is the wav written by AudioOutput::WavWriter
+			AudioPlayer(const std::string& audioFile = "", AudioOutput output = AudioOutput::Device, const std::string& outputFile = "");
 			~AudioPlayer();
 
 			int PauseAudio(bool pause);
 			int PlayAudio();
 			int LoadAudio(const std::string& audioLocation = "");
-			int ReleaseSound();
+			//A resident sound stays decoded so loading the same file again skips decoding
+			int ReleaseSound(bool resident = false);
+			//Frees a resident sound, the one currently loaded is left alone
+			int EvictSound(const std::string& file);
+			//Opens a song in the background and keeps it resident for a later LoadAudio
+			int PreloadSound(const std::string& file);
 
 			bool SetVolume(float volume);
+			//Restarts the mixer with this DSP buffer, a length of 0 goes back to FMOD's defaults
+			bool SetOutput(unsigned int bufferLength, int bufferCount);
+			//Decodes the skin's hitsounds, unchanged files are kept
+			bool SetHitsounds(const HitsoundFiles& files, float volume);
+			Hitsounds& GetHitsounds() { return Effects; }
+			//Clicks the Hit sample every interval seconds on the mixer clock, 0 stops it
+			//A silent metronome still keeps time for visual cues
+			bool SetMetronome(double interval, bool audible = true);
+			//Seconds since the first click, on the mixer clock like GetPosition
+			double GetMetronomeTime();
+
+			//Headless outputs only, mixes exactly this many blocks and returns once they are published
+			//Commands queued before the call are carried out first so runs are repeatable
+			//While a headless player exists Input::Now counts the audio it has mixed
+			bool Advance(unsigned int blocks = 1);
+			bool GetHeadless() const { return Output != AudioOutput::Device; }
 
 			float GetVolume();
-			const std::string& GetAudioFile();
 			unsigned int GetCurrentPos();
+			//Playback position in seconds from the mixer clock, moves once per mixer block
+			double GetPosition();
+			//Output samples mixed since the song started, excluding pauses
+			uint64_t GetPositionSamples();
+			//Mixer clock in output samples when the position was last published
+			uint64_t GetDSPClock();
+			int GetOutputRate();
+			//Output samples mixed per update
+			unsigned int GetBlockLength();
+			//Seconds between a block being mixed and it being heard, from the buffer FMOD accepted
+			double GetOutputLatency();
+			bool GetPaused();
 			unsigned int GetLength();
+			//Decoded PCM held for the loaded song
+			size_t GetSoundBytes();
+			//False while a load, release or play is still queued so an earlier song is never reported
 			bool GetLoaded();
 			bool GetPlaying();
 
 
 			FMOD_RESULT result;
 		private:
+			struct Command
+			{
+				//A Hitsound per sample carries its path, the Hitsounds after them decodes the set
+				enum class Type { Load, Play, Pause, Volume, Release, Evict, Preload, Output, Hitsound, Hitsounds, Metronome };
+
+				Type Action = Type::Play;
+				//Fixed size so queueing a song never allocates
+				char File[OB_AUDIO_PATH_LENGTH] = {};
+				float Value = 0.0f;
+				unsigned int BufferLength = 0;
+				int BufferCount = 0;
+				Hitsound Sample = Hitsound::Hit;
+				bool Enabled = true;
+			};
+			static_assert(std::is_trivially_copyable_v<Command>, "Queueing a command must never allocate");
+
+			//Published by the service thread
+			struct State
+			{
+				//Load, release and play commands carried out
+				uint64_t Applied = 0;
+				uint64_t PositionSamples = 0;
+				uint64_t DSPClock = 0;
+				double Position = 0.0;
+				double Latency = 0.0;
+				double MetronomeTime = 0.0;
+				size_t SoundBytes = 0;
+				unsigned int Length = 0;
+				unsigned int Block = 1024;
+				int Rate = 48000;
+				bool Paused = true;
+				bool Playing = false;
+				bool Loaded = false;
+			};
+
+			static bool SetFile(Command& command, const std::string& file);
+			bool Queue(const Command& command);
+			void Service();
+			void Execute(const Command& command);
+			void Publish();
+
+			bool Initialise(unsigned int bufferLength, int bufferCount);
+			void Reconfigure(unsigned int bufferLength, int bufferCount);
+			//A preloaded sound still opening finishes loading on a later update
+			void Load(const std::string& file);
+			bool Open(const std::string& file);
+			void ServiceOpening();
+			void FinishLoad();
+			void Unload(bool resident);
+			void Play();
+			void Start(int64_t offset);
+			void Pause(bool pause);
+			void StartMetronome(double interval, bool audible);
+			void ServiceMetronome();
+			int64_t GetMixerClock();
+			int64_t GetSamples();
+
 			FMOD::System* system = nullptr;
 			FMOD::Sound* sound = nullptr;
+			//Released songs kept for replays, which stay is decided by the session cache
+			std::unordered_map<std::string, FMOD::Sound*> Resident;
 			FMOD::ChannelGroup* ChannelGroup = nullptr;
 			FMOD::Channel* channel = nullptr;
+			Hitsounds Effects;
+			//Service thread only, paths of the next hitsound set as their commands arrive
+			HitsoundFiles PendingHitsounds;
+
+			float frequency = 44100.0f;
+			std::string LoadedFile;
+
+			AudioOutput Output = AudioOutput::Device;
+			std::string OutputFile;
+			std::atomic<uint64_t> BlocksRequested = 0;
+			std::atomic<uint64_t> BlocksMixed = 0;
+			//Service thread only, output samples mixed by a headless output
+			uint64_t MixedSamples = 0;
+			//Nanoseconds of audio mixed, the Input::Now clock of a headless run
+			std::atomic<int64_t> MixedTime = 0;
+
+			//Service thread only, song time is counted in output samples against the mixer clock
+			unsigned int DefaultLength = 1024;
+			int DefaultCount = 4;
+			unsigned int BufferLength = 1024;
+			int BufferCount = 4;
+			int OutputRate = 48000;
+			int64_t StartClock = 0;
+			int64_t PauseClock = 0;
+			int64_t PausedSamples = 0;
+			bool ChannelPaused = false;
+			//The loaded sound is a preload still being decoded, a play waits for it
+			bool Opening = false;
+			bool PendingPlay = false;
+			//False after a restart failed, nothing is serviced until an output command succeeds
+			bool Initialised = false;
+
+			double MetronomeInterval = 0.0;
+			bool MetronomeAudible = true;
+			int64_t MetronomeStart = 0;
+			int64_t MetronomeClicks = 0;
+
+			MPSCQueue<Command, 64> Commands;
+			std::thread ServiceThread;
+			std::atomic<bool> Running = false;
 
-			double volume = 1.0;
-			int ChannelID = 0;
-			unsigned int length = 0;
-			unsigned int time = 0;
-			std::string AudioFile;
+			//Load, release and play commands queued by callers
+			std::atomic<uint64_t> Issued = 0;
+			std::atomic<double> volume = 1.0;
 
-			bool playing = false;
-			bool loaded = false;
+			//Written by the service thread and published once per update
+			State Current;
+			SeqLock<State> Published;
 	};
-}
\ No newline at end of file
+}
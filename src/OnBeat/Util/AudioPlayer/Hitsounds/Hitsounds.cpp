@@ -0,0 +1,179 @@
+#include <OnBeat/Util/AudioPlayer/Hitsounds/Hitsounds.h>
+#include <OnBeat/Util/AudioPlayer/AudioPlayer.h>
+#include <OnBeat/Util/Input/Input.h>
+#include <algorithm>
+
+namespace OnBeat
+{
+	bool Hitsounds::Trigger(Hitsound sound, int64_t time)
+	{
+		if (!Requests.Push({ sound, time }))
+		{
+			Dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		return true;
+	}
+
+	Hitsounds::Statistics Hitsounds::GetStats() const
+	{
+		Statistics stats;
+		stats.Latency = Latency.load(std::memory_order_relaxed);
+		stats.MaxLatency = MaxLatency.load(std::memory_order_relaxed);
+		stats.Triggers = Triggers.load(std::memory_order_relaxed);
+		stats.Steals = Steals.load(std::memory_order_relaxed);
+		stats.Dropped = Dropped.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	bool Hitsounds::Load(FMOD::System* system, FMOD::ChannelGroup* parent, const HitsoundFiles& files, float volume)
+	{
+		Volume = volume;
+		if (Group && files == Files)
+		{
+			return FMOD_ERRCHECK(Group->setVolume(Volume));
+		}
+
+		Release();
+		Files = files;
+		if (!FMOD_ERRCHECK(system->createChannelGroup("Hitsounds", &Group)))
+		{
+			Group = nullptr;
+			return false;
+		}
+		FMOD_ERRCHECK(Group->setVolume(Volume));
+		//Under the player's group so the master volume covers hitsounds as well as the song
+		if (parent)
+		{
+			FMOD_ERRCHECK(parent->addGroup(Group));
+		}
+
+		//Decoded to PCM now so starting a voice never touches the file
+		bool loaded = true;
+		for (size_t i = 0; i < Files.size(); i++)
+		{
+			if (Files[i].empty())
+				continue;
+
+			if (!FMOD_ERRCHECK(system->createSound(Files[i].c_str(), FMOD_CREATESAMPLE | FMOD_LOOP_OFF, 0, &Samples[i])))
+			{
+				std::cerr << "[Hitsounds - Warning] Could not load " << Files[i] << std::endl;
+				Samples[i] = nullptr;
+				loaded = false;
+			}
+		}
+		Arm(system);
+		return loaded;
+	}
+
+	void Hitsounds::Release()
+	{
+		//Voices are only handles, they die with their sample
+		Voices = {};
+		NextVoice = {};
+		for (auto& sample : Samples)
+		{
+			if (sample)
+			{
+				sample->release();
+				sample = nullptr;
+			}
+		}
+		if (Group)
+		{
+			Group->release();
+			Group = nullptr;
+		}
+	}
+
+	void Hitsounds::Service(FMOD::System* system, unsigned int block, int rate, double outputLatency)
+	{
+		Request request;
+		while (Requests.Pop(request))
+		{
+			//Start exactly one block out so the delay to the speaker is known
+			if (!Play(system, request.Sound, GetClock() + block))
+				continue;
+
+			double latency = ((Input::Now() - request.Time) / 1e9 + (double)block / rate + outputLatency) * 1000.0;
+			double average = Latency.load(std::memory_order_relaxed);
+			Latency.store(Triggers.load(std::memory_order_relaxed) ? average + (latency - average) * 0.05 : latency,
+				std::memory_order_relaxed);
+			MaxLatency.store(std::max(MaxLatency.load(std::memory_order_relaxed), latency), std::memory_order_relaxed);
+			Triggers.fetch_add(1, std::memory_order_relaxed);
+		}
+		Arm(system);
+	}
+
+	bool Hitsounds::Play(FMOD::System* system, Hitsound sound, unsigned long long clock)
+	{
+		if (!Group || !Samples[(size_t)sound])
+			return false;
+
+		//Round robin over the sample's pool, a voice still ringing is rewound for the newest hit
+		VoicePool& pool = Voices[(size_t)sound];
+		size_t& next = NextVoice[(size_t)sound];
+		size_t slot = next;
+		next = (next + 1) % pool.size();
+
+		bool playing = false;
+		bool paused = true;
+		if (!pool[slot] || pool[slot]->isPlaying(&playing) != FMOD_OK || !playing)
+		{
+			//Only when hits come faster than the voices are armed again
+			if (!Arm(system, sound, slot))
+				return false;
+		}
+		else if (pool[slot]->getPaused(&paused) == FMOD_OK && !paused)
+		{
+			pool[slot]->setPosition(0, FMOD_TIMEUNIT_PCM);
+			Steals.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		FMOD::Channel* voice = pool[slot];
+		voice->setDelay(clock, 0, false);
+		voice->setPaused(false);
+		return true;
+	}
+
+	void Hitsounds::Arm(FMOD::System* system)
+	{
+		for (size_t sound = 0; sound < Voices.size(); sound++)
+		{
+			if (!Samples[sound])
+				continue;
+
+			for (size_t slot = 0; slot < Voices[sound].size(); slot++)
+			{
+				//A voice that has finished is an invalid handle
+				bool playing = false;
+				FMOD::Channel* voice = Voices[sound][slot];
+				if (!voice || voice->isPlaying(&playing) != FMOD_OK || !playing)
+				{
+					Arm(system, (Hitsound)sound, slot);
+				}
+			}
+		}
+	}
+
+	bool Hitsounds::Arm(FMOD::System* system, Hitsound sound, size_t slot)
+	{
+		FMOD::Channel*& voice = Voices[(size_t)sound][slot];
+		if (system->playSound(Samples[(size_t)sound], Group, true, &voice) != FMOD_OK)
+		{
+			voice = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	unsigned long long Hitsounds::GetClock()
+	{
+		unsigned long long clock = 0;
+		if (Group)
+		{
+			Group->getDSPClock(&clock, nullptr);
+		}
+		return clock;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <FMOD/fmod.hpp>
+#include <OnBeat/Util/Queue/MPSCQueue.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#define OB_HITSOUND_VOICES 16
+
+namespace OnBeat
+{
+	enum class Hitsound : uint8_t
+	{
+		Hit,
+		Miss,
+		Count
+	};
+
+	typedef std::array<std::string, (size_t)Hitsound::Count> HitsoundFiles;
+
+	//Short skin samples decoded up front and played on a fixed set of voices
+	//Trigger only pushes onto a preallocated queue, the audio service thread unpauses a voice armed ahead of time
+	class Hitsounds
+	{
+		public:
+			struct Statistics
+			{
+				//Milliseconds from the press timestamp to the sample reaching the speaker
+				double Latency = 0.0;
+				double MaxLatency = 0.0;
+				uint64_t Triggers = 0;
+				uint64_t Steals = 0;
+				uint64_t Dropped = 0;
+			};
+
+			//Safe from any thread, time is on the Input::Now clock
+			bool Trigger(Hitsound sound, int64_t time);
+
+			Statistics GetStats() const;
+
+		private:
+			friend class AudioPlayer;
+
+			struct Request
+			{
+				Hitsound Sound = Hitsound::Hit;
+				int64_t Time = 0;
+			};
+
+			typedef std::array<FMOD::Channel*, OB_HITSOUND_VOICES / (size_t)Hitsound::Count> VoicePool;
+
+			//Service thread only, the group plays under parent so its volume applies
+			bool Load(FMOD::System* system, FMOD::ChannelGroup* parent, const HitsoundFiles& files, float volume);
+			void Release();
+			void Service(FMOD::System* system, unsigned int block, int rate, double outputLatency);
+			//Starts a voice when the group's DSP clock reaches clock
+			bool Play(FMOD::System* system, Hitsound sound, unsigned long long clock);
+			//Creates paused voices for every slot whose last one has finished
+			void Arm(FMOD::System* system);
+			bool Arm(FMOD::System* system, Hitsound sound, size_t slot);
+			unsigned long long GetClock();
+
+			FMOD::ChannelGroup* Group = nullptr;
+			std::array<FMOD::Sound*, (size_t)Hitsound::Count> Samples = {};
+			std::array<VoicePool, (size_t)Hitsound::Count> Voices = {};
+			std::array<size_t, (size_t)Hitsound::Count> NextVoice = {};
+			HitsoundFiles Files;
+			float Volume = 1.0f;
+
+			MPSCQueue<Request, 256> Requests;
+
+			std::atomic<double> Latency = 0.0;
+			std::atomic<double> MaxLatency = 0.0;
+			std::atomic<uint64_t> Triggers = 0;
+			std::atomic<uint64_t> Steals = 0;
+			std::atomic<uint64_t> Dropped = 0;
+	};
+}
@@ -0,0 +1,45 @@
+#include <OnBeat/Util/FNV/FNV.h>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace OnBeat
+{
+	uint64_t FNV::Hash(uint64_t hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * Prime;
+		}
+		return hash;
+	}
+
+	uint64_t FNV::File(std::istream& input, uint64_t size)
+	{
+		std::vector<char> buffer(OB_FNV_FILE_SPAN);
+		uint64_t hash = Hash(Offset, size);
+		input.clear();
+		input.seekg(0);
+		input.read(buffer.data(), buffer.size());
+		hash = Hash(hash, buffer.data(), (size_t)input.gcount());
+		input.clear();
+		if (size > OB_FNV_FILE_SPAN)
+		{
+			input.seekg(size - std::min<uint64_t>(size - OB_FNV_FILE_SPAN, OB_FNV_FILE_SPAN));
+			input.read(buffer.data(), buffer.size());
+			hash = Hash(hash, buffer.data(), (size_t)input.gcount());
+		}
+		return hash;
+	}
+
+	uint64_t FNV::File(const std::string& file)
+	{
+		std::ifstream input(file, std::ios::binary);
+		if (!input)
+			return 0;
+
+		input.seekg(0, std::ios::end);
+		return File(input, (uint64_t)input.tellg());
+	}
+}
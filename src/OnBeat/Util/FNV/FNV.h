@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+
+//Bytes hashed from each end of a file
+#define OB_FNV_FILE_SPAN (1 << 16)
+
+namespace OnBeat
+{
+	//FNV-1a, a hash is extended by passing it back in
+	class FNV
+	{
+		public:
+			static constexpr uint64_t Offset = 14695981039346656037ull;
+			static constexpr uint64_t Prime = 1099511628211ull;
+
+			static uint64_t Hash(uint64_t hash, const void* data, size_t size);
+			template<typename T>
+			static uint64_t Hash(uint64_t hash, const T& value) { return Hash(hash, &value, sizeof(T)); }
+
+			//Size and the first and last 64 KiB rather than the whole song, the middle is never edited on its own
+			static uint64_t File(std::istream& input, uint64_t size);
+			//0 when the file cannot be read
+			static uint64_t File(const std::string& file);
+	};
+}
@@ -0,0 +1,107 @@
+#include <OnBeat/Util/FramePacer/FramePacer.h>
+#include <OnBeat/Util/Input/Input.h>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "Winmm.lib")
+#endif
+
+namespace OnBeat
+{
+	FramePacer::FramePacer()
+	{
+#ifdef _WIN32
+		//Default scheduler tick is ~15ms which makes every sleep overshoot
+		timeBeginPeriod(1);
+#endif
+	}
+
+	void FramePacer::SetCap(int fps)
+	{
+		Cap = std::max(fps, 0);
+		Period = Cap ? 1000000000LL / Cap : 0;
+		Deadline = 0;
+	}
+
+	void FramePacer::Wait()
+	{
+		//Render ahead limit, the previous frame must have reached the GPU before starting another
+		if (Fence)
+		{
+			int64_t fenceStart = Input::Now();
+			glClientWaitSync(Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+			glDeleteSync(Fence);
+			Fence = nullptr;
+			Stats.GpuWait += ((Input::Now() - fenceStart) / 1e6 - Stats.GpuWait) * 0.05;
+		}
+
+		int64_t now = Input::Now();
+		if (Period)
+		{
+			Deadline = Deadline ? Deadline + Period : now;
+			//Fell more than a frame behind, start a new cadence rather than rushing frames
+			if (now - Deadline > Period)
+			{
+				Deadline = now;
+			}
+
+			int64_t sleep = Deadline - now - SpinMargin;
+			if (sleep > 0)
+			{
+				//Waiting on events rather than sleeping, key callbacks stamp presses as they arrive instead of next frame
+				int64_t wake = now + sleep;
+				for (int64_t left = sleep; left > 0; left = wake - Input::Now())
+				{
+					glfwWaitEventsTimeout(left / 1e9);
+				}
+				int64_t overshoot = Input::Now() - wake;
+				//Grow quickly after a late wake, shrink slowly
+				SpinMargin = std::clamp(std::max(overshoot + overshoot / 2, SpinMargin - SpinMargin / 64),
+					(int64_t)200000, Period);
+			}
+
+			int64_t spinStart = Input::Now();
+			while (Input::Now() < Deadline)
+			{
+				std::this_thread::yield();
+			}
+			now = Input::Now();
+			Stats.SpinTime += ((now - spinStart) / 1e6 - Stats.SpinTime) * 0.05;
+		}
+
+		if (LastStart)
+		{
+			double frameTime = (now - LastStart) / 1e6;
+			Stats.FrameTime += (frameTime - Stats.FrameTime) * 0.05;
+			Stats.Jitter += (std::abs(frameTime - Stats.FrameTime) - Stats.Jitter) * 0.05;
+		}
+		LastStart = now;
+		Stats.Frames++;
+	}
+
+	void FramePacer::EndFrame()
+	{
+		if (Fence)
+		{
+			glDeleteSync(Fence);
+		}
+		Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	FramePacer::~FramePacer()
+	{
+#ifdef _WIN32
+		timeEndPeriod(1);
+#endif
+	}
+}
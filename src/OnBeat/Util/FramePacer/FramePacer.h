@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+
+typedef struct __GLsync* GLsync;
+
+namespace OnBeat
+{
+	//Frame limiter that waits on window events for most of the frame and spins the rest on a monotonic clock
+	class FramePacer
+	{
+		public:
+			struct Statistics
+			{
+				//Milliseconds, smoothed
+				double FrameTime = 0.0;
+				double Jitter = 0.0;
+				double SpinTime = 0.0;
+				double GpuWait = 0.0;
+				uint64_t Frames = 0;
+			};
+
+			FramePacer();
+			~FramePacer();
+
+			//0 leaves the frame rate uncapped
+			void SetCap(int fps);
+			int GetCap() const { return Cap; }
+
+			//Call at the start of a frame, returns once the frame may begin
+			void Wait();
+			//Call once the frame's draw calls are submitted, limits the GPU to one frame behind
+			void EndFrame();
+
+			const Statistics& GetStats() const { return Stats; }
+
+		private:
+			int Cap = 0;
+			int64_t Period = 0;
+			int64_t Deadline = 0;
+			int64_t LastStart = 0;
+
+			//Sleep overshoot allowance, learnt from how late sleeps wake
+			int64_t SpinMargin = 2000000;
+
+			GLsync Fence = nullptr;
+
+			Statistics Stats;
+	};
+}
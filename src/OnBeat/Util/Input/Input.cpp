@@ -0,0 +1,186 @@
+#include <OnBeat/Util/Input/Input.h>
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <functional>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#define GLFW_EXPOSE_NATIVE_WIN32
+#include <GLFW/glfw3native.h>
+#endif
+
+namespace OnBeat
+{
+	std::atomic<const std::atomic<int64_t>*> Input::Clock = nullptr;
+
+	Input& Input::Get()
+	{
+		static Input input;
+		return input;
+	}
+
+	void Input::Attach(GLFWwindow* window)
+	{
+		KeyFunction previous = glfwSetKeyCallback(window, &Input::KeyCallback);
+		//Attaching twice would chain onto ourselves
+		if (previous != &Input::KeyCallback)
+		{
+			Previous = previous;
+		}
+#ifdef _WIN32
+		if (!RawThread.joinable())
+			StartRawInput(window);
+#endif
+	}
+
+	void Input::Detach()
+	{
+#ifdef _WIN32
+		if (RawThread.joinable())
+		{
+			PostThreadMessageW(RawThreadId, WM_QUIT, 0, 0);
+			RawThread.join();
+		}
+		Raw = false;
+#endif
+	}
+
+	bool Input::Pop(KeyPress& press)
+	{
+		int64_t cleared = ClearedAt.load(std::memory_order_acquire);
+		while (Presses.Pop(press))
+		{
+			if (press.Time >= cleared)
+				return true;
+		}
+		return false;
+	}
+
+	void Input::Clear()
+	{
+		//Stamps come from the same clock so anything already queued is older than this
+		ClearedAt.store(Now(), std::memory_order_release);
+	}
+
+	int64_t Input::Now()
+	{
+		if (const std::atomic<int64_t>* clock = Clock.load(std::memory_order_acquire))
+		{
+			return clock->load(std::memory_order_acquire);
+		}
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void Input::SetClock(const std::atomic<int64_t>* clock)
+	{
+		Clock.store(clock, std::memory_order_release);
+	}
+
+	void Input::KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+	{
+		//Stamp first, before anything else runs
+		int64_t time = Now();
+
+		Input& input = Get();
+		if (action != GLFW_REPEAT && !input.Raw)
+		{
+			input.Push(key, action == GLFW_PRESS, time);
+		}
+
+		if (input.Previous)
+		{
+			input.Previous(window, key, scancode, action, mods);
+		}
+	}
+
+	void Input::Push(int key, bool pressed, int64_t time)
+	{
+		if (!Presses.Push({ key, pressed, time }))
+		{
+			Dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+#ifdef _WIN32
+	void Input::StartRawInput(GLFWwindow* window)
+	{
+		//GLFW's scancodes are Win32 make codes with 0x100 for extended keys, the same as raw input reports
+		Keys.fill(GLFW_KEY_UNKNOWN);
+		for (int key = GLFW_KEY_SPACE; key <= GLFW_KEY_LAST; key++)
+		{
+			int scancode = glfwGetKeyScancode(key);
+			if (scancode >= 0 && scancode < (int)Keys.size())
+				Keys[scancode] = key;
+		}
+
+		std::promise<bool> started;
+		std::future<bool> result = started.get_future();
+		RawThread = std::thread(&Input::ReadRawInput, this, (void*)glfwGetWin32Window(window), std::ref(started));
+		Raw = result.get();
+		if (!Raw)
+		{
+			RawThread.join();
+		}
+	}
+
+	void Input::ReadRawInput(void* window, std::promise<bool>& started)
+	{
+		//Stamping is all this thread does, it must not wait behind anything else
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+		RawThreadId = GetCurrentThreadId();
+
+		//Message only window, raw keyboard input is queued to this thread whichever window has focus
+		HWND sink = CreateWindowExW(0, L"Message", nullptr, 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, nullptr, nullptr);
+		RAWINPUTDEVICE device = { 0x01, 0x06, RIDEV_INPUTSINK, sink };
+		if (!sink || !RegisterRawInputDevices(&device, 1, sizeof(device)))
+		{
+			if (sink)
+				DestroyWindow(sink);
+			started.set_value(false);
+			return;
+		}
+		//The queue exists now, so Detach's WM_QUIT cannot be lost
+		MSG message;
+		PeekMessageW(&message, nullptr, 0, 0, PM_NOREMOVE);
+		started.set_value(true);
+
+		std::array<bool, 512> down = {};
+		while (GetMessageW(&message, nullptr, 0, 0) > 0)
+		{
+			if (message.message == WM_INPUT)
+			{
+				int64_t time = Now();
+				RAWINPUT raw;
+				UINT size = sizeof(raw);
+				if (GetRawInputData((HRAWINPUT)message.lParam, RID_INPUT, &raw, &size, sizeof(RAWINPUTHEADER)) != (UINT)-1 &&
+					raw.header.dwType == RIM_TYPEKEYBOARD)
+				{
+					const RAWKEYBOARD& keyboard = raw.data.keyboard;
+					int scancode = (keyboard.MakeCode & 0xff) | ((keyboard.Flags & RI_KEY_E0) ? 0x100 : 0);
+					bool pressed = !(keyboard.Flags & RI_KEY_BREAK);
+					//Held keys repeat their make code, only changes are presses
+					if (down[scancode] != pressed)
+					{
+						down[scancode] = pressed;
+						//Keys typed into other applications are not gameplay
+						if (GetForegroundWindow() == (HWND)window && Keys[scancode] != GLFW_KEY_UNKNOWN)
+							Push(Keys[scancode], pressed, time);
+					}
+				}
+			}
+			//DefWindowProc releases the raw input buffer
+			DispatchMessageW(&message);
+		}
+		DestroyWindow(sink);
+	}
+#endif
+
+	Input::~Input()
+	{
+		Detach();
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <OnBeat/Util/Queue/SPSCQueue.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <thread>
+
+typedef struct GLFWwindow GLFWwindow;
+
+namespace OnBeat
+{
+	//Key state change stamped when the OS delivers it
+	struct KeyPress
+	{
+		int Key = 0;
+		bool Pressed = false;
+		//Nanoseconds on the Input::Now clock
+		int64_t Time = 0;
+	};
+
+	//Gameplay input, presses are stamped and queued instead of waiting for the event stack
+	//On Windows a raw input thread stamps keys as they arrive, independent of the frame rate
+	//Elsewhere GLFW's key callback stamps them, at once while the frame pacer waits on events
+	//but a press made while a frame renders is only stamped by the next poll, so up to that frame's busy time late
+	class Input
+	{
+		public:
+			static Input& Get();
+
+			//Chains onto the window's key callback so Hazel events still fire, main thread only
+			void Attach(GLFWwindow* window);
+			//Stops the raw input thread
+			void Detach();
+
+			//Consumer thread only, skips presses stamped before the last Clear
+			bool Pop(KeyPress& press);
+			//Safe from any thread, the queue is only ever popped by its consumer
+			void Clear();
+
+			uint64_t GetDropped() const { return Dropped.load(std::memory_order_relaxed); }
+			//Producer thread only, also how replays and tests feed stamped presses
+			void Push(int key, bool pressed, int64_t time);
+
+			static int64_t Now();
+			//Headless audio drives Now from the blocks it has mixed, nullptr goes back to the steady clock
+			static void SetClock(const std::atomic<int64_t>* clock);
+
+		private:
+			Input() {}
+			~Input();
+
+			static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+#ifdef _WIN32
+			//Returns once the thread has registered for raw input or failed to
+			void StartRawInput(GLFWwindow* window);
+			void ReadRawInput(void* window, std::promise<bool>& started);
+
+			std::thread RawThread;
+			unsigned long RawThreadId = 0;
+			//GLFW key for each Win32 scancode, extended keys have 0x100 set
+			std::array<int, 512> Keys;
+#endif
+			//The raw input thread is the queue's producer, the key callback only chains on
+			bool Raw = false;
+
+			typedef void (*KeyFunction)(GLFWwindow*, int, int, int, int);
+			KeyFunction Previous = nullptr;
+
+			static std::atomic<const std::atomic<int64_t>*> Clock;
+
+			SPSCQueue<KeyPress, 256> Presses;
+			std::atomic<int64_t> ClearedAt = 0;
+			std::atomic<uint64_t> Dropped = 0;
+	};
+}
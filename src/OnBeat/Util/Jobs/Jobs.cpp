@@ -0,0 +1,269 @@
+#include <OnBeat/Util/Jobs/Jobs.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace OnBeat
+{
+	//Index of the worker running on this thread, SIZE_MAX off the pool
+	static thread_local size_t WorkerIndex = SIZE_MAX;
+	static thread_local bool SerialThread = false;
+
+	JobHandle::JobHandle()
+		: State(std::make_shared<Data>())
+	{
+	}
+
+	void JobHandle::Wait() const
+	{
+		if (GetFinished() || JobSystem::Get().RunJob(*this))
+			return;
+
+		//Whoever took it is running it, its own waits are served the same way so this always finishes
+		std::unique_lock<std::mutex> lock(State->Lock);
+		State->Done.wait(lock, [this]() { return GetFinished(); });
+	}
+
+	JobHandle& JobHandle::Then(std::function<void()> fn)
+	{
+		//Cancelled is checked again on the main thread, the owner may have gone since the job finished
+		JobHandle handle = *this;
+		std::function<void()> continuation = [handle, fn]()
+		{
+			if (!handle.GetCancelled())
+				fn();
+		};
+
+		{
+			std::lock_guard<std::mutex> lock(State->Lock);
+			if (!GetFinished())
+			{
+				State->Continuations.push_back(std::move(continuation));
+				return *this;
+			}
+		}
+		JobSystem::Get().Post(std::move(continuation));
+		return *this;
+	}
+
+	JobSystem& JobSystem::Get()
+	{
+		static JobSystem jobs;
+		return jobs;
+	}
+
+	JobSystem::JobSystem()
+	{
+		//Main, audio and simulation threads already want a core, 0 means the count is unknown
+		unsigned int cores = std::thread::hardware_concurrency();
+		size_t count = cores > 1 ? cores - 1 : 1;
+		for (size_t i = 0; i < count; i++)
+		{
+			Queues.push_back(std::make_unique<Queue>());
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			Workers.emplace_back(&JobSystem::Work, this, i);
+		}
+	}
+
+	JobHandle JobSystem::Schedule(JobFunction fn)
+	{
+		Task task;
+		task.Fn = std::move(fn);
+		JobHandle handle = task.Handle;
+		Push(std::move(task));
+		return handle;
+	}
+
+	void JobSystem::ParallelFor(size_t count, const std::function<void(size_t, size_t)>& fn)
+	{
+		if (count == 0)
+			return;
+
+		//Threads that keep to their own core budget run it inline
+		if (SerialThread)
+		{
+			fn(0, count);
+			return;
+		}
+
+		//A few blocks per thread so a slow block can be balanced by stealing
+		size_t blocks = std::min(count, (Workers.size() + 1) * 4);
+		size_t block = (count + blocks - 1) / blocks;
+		std::vector<JobHandle> handles;
+		handles.reserve(blocks);
+		for (size_t start = 0; start < count; start += block)
+		{
+			size_t end = std::min(start + block, count);
+			handles.push_back(Schedule([&fn, start, end](JobHandle&) { fn(start, end); }));
+		}
+		for (auto& handle : handles)
+		{
+			handle.Wait();
+		}
+	}
+
+	void JobSystem::SetSerial(bool serial)
+	{
+		SerialThread = serial;
+	}
+
+	void JobSystem::Post(std::function<void()> fn)
+	{
+		std::lock_guard<std::mutex> lock(MainLock);
+		MainThread.push_back(std::move(fn));
+	}
+
+	void JobSystem::RunMainThread()
+	{
+		std::vector<std::function<void()>> work;
+		{
+			std::lock_guard<std::mutex> lock(MainLock);
+			work.swap(MainThread);
+		}
+		for (auto& fn : work)
+		{
+			fn();
+		}
+	}
+
+	bool JobSystem::RunOne()
+	{
+		Task task;
+		size_t worker = WorkerIndex < Queues.size() ? WorkerIndex : 0;
+		if ((WorkerIndex < Queues.size() && Pop(worker, task)) || Steal(worker, task))
+		{
+			Run(task);
+			return true;
+		}
+		return false;
+	}
+
+	bool JobSystem::RunJob(const JobHandle& handle)
+	{
+		Task task;
+		bool found = false;
+		for (size_t i = 0; i < Queues.size() && !found; i++)
+		{
+			Queue& queue = *Queues[i];
+			std::lock_guard<std::mutex> lock(queue.Lock);
+			auto it = std::find_if(queue.Tasks.begin(), queue.Tasks.end(),
+				[&handle](const Task& queued) { return queued.Handle.State == handle.State; });
+			if (it != queue.Tasks.end())
+			{
+				task = std::move(*it);
+				queue.Tasks.erase(it);
+				Queued.fetch_sub(1, std::memory_order_relaxed);
+				found = true;
+			}
+		}
+
+		if (found)
+		{
+			Run(task);
+		}
+		return found;
+	}
+
+	void JobSystem::Push(Task&& task)
+	{
+		//Workers keep what they spawn, anything else is spread round robin
+		size_t index = WorkerIndex < Queues.size() ? WorkerIndex : NextQueue.fetch_add(1, std::memory_order_relaxed) % Queues.size();
+		{
+			std::lock_guard<std::mutex> lock(Queues[index]->Lock);
+			Queues[index]->Tasks.push_back(std::move(task));
+		}
+		Queued.fetch_add(1, std::memory_order_release);
+
+		//Taking the lock orders this with a worker checking Queued before it sleeps
+		{
+			std::lock_guard<std::mutex> lock(SleepLock);
+		}
+		Wake.notify_one();
+	}
+
+	bool JobSystem::Pop(size_t worker, Task& task)
+	{
+		Queue& queue = *Queues[worker];
+		std::lock_guard<std::mutex> lock(queue.Lock);
+		if (queue.Tasks.empty())
+			return false;
+
+		//Newest first, its data is most likely still in cache
+		task = std::move(queue.Tasks.back());
+		queue.Tasks.pop_back();
+		Queued.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool JobSystem::Steal(size_t worker, Task& task)
+	{
+		for (size_t i = 0; i < Queues.size(); i++)
+		{
+			size_t victim = (worker + i) % Queues.size();
+			if (victim == WorkerIndex)
+				continue;
+
+			Queue& queue = *Queues[victim];
+			std::lock_guard<std::mutex> lock(queue.Lock);
+			if (queue.Tasks.empty())
+				continue;
+
+			//Oldest first, usually the biggest piece of work left
+			task = std::move(queue.Tasks.front());
+			queue.Tasks.pop_front();
+			Queued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	void JobSystem::Run(Task& task)
+	{
+		if (task.Fn && !task.Handle.GetCancelled())
+		{
+			task.Fn(task.Handle);
+		}
+
+		std::vector<std::function<void()>> continuations;
+		{
+			std::lock_guard<std::mutex> lock(task.Handle.State->Lock);
+			task.Handle.State->Finished.store(true, std::memory_order_release);
+			continuations.swap(task.Handle.State->Continuations);
+		}
+		task.Handle.State->Done.notify_all();
+		for (auto& fn : continuations)
+		{
+			Post(std::move(fn));
+		}
+	}
+
+	void JobSystem::Work(size_t worker)
+	{
+		WorkerIndex = worker;
+		while (Running.load(std::memory_order_acquire))
+		{
+			if (RunOne())
+				continue;
+
+			std::unique_lock<std::mutex> lock(SleepLock);
+			Wake.wait(lock, [this]()
+				{
+					return Queued.load(std::memory_order_acquire) > 0 || !Running.load(std::memory_order_acquire);
+				});
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(SleepLock);
+			Running = false;
+		}
+		Wake.notify_all();
+		for (auto& worker : Workers)
+		{
+			worker.join();
+		}
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OnBeat
+{
+	class JobHandle;
+	typedef std::function<void(JobHandle&)> JobFunction;
+
+	//Shared state of one scheduled job, copies all refer to the same job
+	//Cancelling is cooperative, the job has to check GetCancelled and return early
+	class JobHandle
+	{
+		public:
+			JobHandle();
+
+			bool GetFinished() const { return State->Finished.load(std::memory_order_acquire); }
+			bool GetCancelled() const { return State->Cancelled.load(std::memory_order_acquire); }
+			//0 to 1, set from inside the job
+			float GetProgress() const { return State->Progress.load(std::memory_order_relaxed); }
+
+			void SetProgress(float progress) { State->Progress.store(progress, std::memory_order_relaxed); }
+			void Cancel() { State->Cancelled.store(true, std::memory_order_release); }
+
+			//Runs the job here if nobody has started it, otherwise blocks until it finishes
+			//Unrelated jobs are never picked up so a wait is not held up behind them
+			void Wait() const;
+
+			//Run on the main thread after the job finishes, skipped if it was cancelled
+			JobHandle& Then(std::function<void()> fn);
+
+		private:
+			friend class JobSystem;
+
+			struct Data
+			{
+				std::atomic<bool> Finished = false;
+				std::atomic<bool> Cancelled = false;
+				std::atomic<float> Progress = 0.0f;
+
+				std::mutex Lock;
+				std::condition_variable Done;
+				std::vector<std::function<void()>> Continuations;
+			};
+
+			std::shared_ptr<Data> State;
+	};
+
+	//Fixed worker pool shared by loading, analysis and file work
+	//Each worker owns a deque, it takes its newest job and steals the oldest from others when empty
+	class JobSystem
+	{
+		public:
+			static JobSystem& Get();
+
+			JobHandle Schedule(JobFunction fn);
+
+			//Splits [0, count) into blocks run across the pool, the caller helps until they are all done
+			void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& fn);
+
+			//Queue work for the main thread, such as GL uploads of data decoded by a job
+			void Post(std::function<void()> fn);
+			//Main thread, runs everything posted since the last call
+			void RunMainThread();
+
+			//Takes this job off the queues and runs it on the calling thread, false once it has started elsewhere
+			bool RunJob(const JobHandle& handle);
+
+			//ParallelFor called from this thread runs inline, for threads that have to stay on their own core budget
+			static void SetSerial(bool serial);
+
+			size_t GetWorkerCount() const { return Workers.size(); }
+
+		private:
+			JobSystem();
+			~JobSystem();
+
+			struct Task
+			{
+				JobFunction Fn;
+				JobHandle Handle;
+			};
+
+			struct Queue
+			{
+				std::mutex Lock;
+				std::deque<Task> Tasks;
+			};
+
+			void Push(Task&& task);
+			bool Pop(size_t worker, Task& task);
+			bool Steal(size_t worker, Task& task);
+			//Runs one queued job on the calling worker, false when there was nothing to do
+			bool RunOne();
+			void Run(Task& task);
+			void Work(size_t worker);
+
+			std::vector<std::thread> Workers;
+			std::vector<std::unique_ptr<Queue>> Queues;
+			std::atomic<size_t> NextQueue = 0;
+			std::atomic<bool> Running = true;
+
+			//Queued task count, idle workers sleep on it
+			std::atomic<size_t> Queued = 0;
+			std::mutex SleepLock;
+			std::condition_variable Wake;
+
+			std::mutex MainLock;
+			std::vector<std::function<void()>> MainThread;
+	};
+}
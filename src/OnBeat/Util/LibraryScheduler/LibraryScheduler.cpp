@@ -0,0 +1,279 @@
+#include <OnBeat/Util/LibraryScheduler/LibraryScheduler.h>
+#include <OnBeat/Util/Jobs/Jobs.h>
+#include <OnBeat/Util/SongLibrary/SongLibrary.h>
+#include <Hazel/Core/Log.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace OnBeat
+{
+	LibraryScheduler& LibraryScheduler::Get()
+	{
+		static LibraryScheduler scheduler;
+		return scheduler;
+	}
+
+	void LibraryScheduler::Configure(const std::vector<std::string>& folders, const OnSetOptions& options,
+		int frameSize, int sampleRate, unsigned int cores)
+	{
+		if (Running && folders == Folders && cores == Cores && frameSize == FrameSize && sampleRate == SampleRate &&
+			AnalysisCache::HashOptions(options, frameSize) == AnalysisCache::HashOptions(Options, FrameSize))
+		{
+			return;
+		}
+
+		Stop();
+		Folders = folders;
+		Options = options;
+		FrameSize = frameSize;
+		SampleRate = sampleRate;
+		Cores = cores;
+		if (Folders.empty() || Cores == 0)
+			return;
+
+		LoadProgress();
+		Pending.clear();
+		Walked = false;
+		Walking = false;
+		Songs = 0;
+		Failed = 0;
+		Done = Finished.size();
+
+		Running = true;
+		for (unsigned int i = 0; i < Cores; i++)
+		{
+			Workers.emplace_back(&LibraryScheduler::Work, this);
+		}
+	}
+
+	void LibraryScheduler::Pause()
+	{
+		std::lock_guard<std::mutex> lock(Lock);
+		Paused = true;
+	}
+
+	void LibraryScheduler::Resume()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			Paused = false;
+		}
+		Wake.notify_all();
+	}
+
+	void LibraryScheduler::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			Running = false;
+		}
+		Wake.notify_all();
+		for (auto& worker : Workers)
+		{
+			worker.join();
+		}
+		Workers.clear();
+		Flush();
+	}
+
+	LibraryScheduler::Statistics LibraryScheduler::GetStats() const
+	{
+		Statistics stats;
+		stats.Songs = Songs.load(std::memory_order_relaxed);
+		stats.Done = Done.load(std::memory_order_relaxed);
+		stats.Failed = Failed.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	void LibraryScheduler::Work()
+	{
+		//Frames always win, the OS only gives these workers time nothing else wants
+#ifdef _WIN32
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE);
+#elif defined(__linux__)
+		setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19);
+#endif
+		//One worker is one core of the budget, analysis must not spill onto the job pool
+		JobSystem::SetSerial(true);
+
+		{
+			std::unique_lock<std::mutex> lock(Lock);
+			if (!Walked && !Walking)
+			{
+				Walking = true;
+				lock.unlock();
+				Walk();
+				lock.lock();
+				Walked = true;
+				Wake.notify_all();
+			}
+			Wake.wait(lock, [this]() { return Walked || !Running; });
+		}
+
+		SongEntry song;
+		while (Wait() && Next(song))
+		{
+			AnalysisResult result;
+			//The library hashed the song when it was scanned
+			bool analysed = AnalysisCache::Analyse(song.Path, Options, FrameSize, SampleRate, result,
+				[this](double) { return Wait(); }, song.Hash);
+
+			//Stopped part way, the song stays pending for the next run
+			if (!Wait())
+				return;
+			Finish(song, analysed);
+		}
+	}
+
+	bool LibraryScheduler::Wait()
+	{
+		std::unique_lock<std::mutex> lock(Lock);
+		if (Paused && Running && Unsaved > 0)
+		{
+			//Progress is on disk before gameplay, the game may be closed from there
+			lock.unlock();
+			Flush();
+			lock.lock();
+		}
+		Wake.wait(lock, [this]() { return !Paused || !Running; });
+		return Running;
+	}
+
+	void LibraryScheduler::Walk()
+	{
+		//The song library is configured with the same folders, its first scan is a stat per song at most
+		//Lock is taken before notifying so a scan ending between the check and the wait is not missed
+		SongLibrary::Get().SetScanCallback([this]()
+			{
+				{
+					std::lock_guard<std::mutex> lock(Lock);
+				}
+				Wake.notify_all();
+			});
+		std::unique_lock<std::mutex> lock(Lock);
+		Wake.wait(lock, [this]() { return !Running || !SongLibrary::Get().GetScanning(); });
+		//The library may outlive this scheduler
+		SongLibrary::Get().SetScanCallback(nullptr);
+		SongList songs = SongLibrary::Get().GetSongs();
+
+		Songs = songs->size();
+		size_t done = 0;
+		for (auto& song : *songs)
+		{
+			if (Finished.count(GetSongId(song)))
+				done++;
+			else
+				Pending.push_back(song);
+		}
+		Done = done;
+
+		//Popped from the back, so the folder is worked through in name order
+		std::reverse(Pending.begin(), Pending.end());
+		HZ_INFO("Library: {0} songs, {1} already analysed", songs->size(), done);
+	}
+
+	bool LibraryScheduler::Next(SongEntry& song)
+	{
+		std::lock_guard<std::mutex> lock(Lock);
+		if (Pending.empty())
+			return false;
+		song = std::move(Pending.back());
+		Pending.pop_back();
+		return true;
+	}
+
+	void LibraryScheduler::Finish(const SongEntry& song, bool analysed)
+	{
+		std::string id = GetSongId(song);
+		bool save;
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			//Unreadable songs are recorded too so they are not retried every start
+			Finished.insert(id);
+			Done++;
+			if (!analysed)
+				Failed++;
+			save = ++Unsaved >= OB_LIBRARY_SAVE_INTERVAL;
+		}
+		if (save)
+			Flush();
+	}
+
+	void LibraryScheduler::LoadProgress()
+	{
+		Finished.clear();
+		Unsaved = 0;
+		std::ifstream input(OB_LIBRARY_PROGRESS);
+		if (!input)
+			return;
+
+		nlohmann::json progress = nlohmann::json::parse(input, nullptr, false);
+		if (progress.is_discarded() || !progress.is_object())
+			return;
+
+		//Different options make every earlier result useless
+		if (progress.value("Options", (uint64_t)0) != AnalysisCache::HashOptions(Options, FrameSize))
+			return;
+		for (auto& id : progress["Finished"])
+		{
+			if (id.is_string())
+				Finished.insert(id.get<std::string>());
+		}
+	}
+
+	void LibraryScheduler::Flush()
+	{
+		std::lock_guard<std::mutex> save(SaveLock);
+		std::vector<std::string> finished;
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			if (Unsaved == 0)
+				return;
+			Unsaved = 0;
+			finished.assign(Finished.begin(), Finished.end());
+		}
+		SaveProgress(finished);
+	}
+
+	void LibraryScheduler::SaveProgress(const std::vector<std::string>& finished) const
+	{
+		nlohmann::json progress;
+		progress["Options"] = AnalysisCache::HashOptions(Options, FrameSize);
+		progress["Finished"] = finished;
+
+		std::error_code error;
+		std::filesystem::create_directories(OB_ANALYSIS_CACHE, error);
+		std::string temporary = std::string(OB_LIBRARY_PROGRESS) + ".tmp";
+		{
+			std::ofstream output(temporary, std::ios::trunc);
+			output << progress.dump();
+			if (!output)
+				return;
+		}
+		std::filesystem::rename(temporary, OB_LIBRARY_PROGRESS, error);
+	}
+
+	std::string LibraryScheduler::GetSongId(const SongEntry& song)
+	{
+		return song.Path + "|" + std::to_string(song.Size) + "|" + std::to_string(song.Modified);
+	}
+
+	LibraryScheduler::~LibraryScheduler()
+	{
+		Stop();
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <OnBeat/Util/OnSetDetection/AnalysisCache/AnalysisCache.h>
+#include <OnBeat/Util/SongLibrary/SongLibrary.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#define OB_LIBRARY_PROGRESS OB_ANALYSIS_CACHE "/progress.json"
+//Songs finished between progress writes, pausing and stopping write the rest
+#define OB_LIBRARY_SAVE_INTERVAL 16
+
+namespace OnBeat
+{
+	//Analyses every song in the music folders into the analysis cache while the game sits in its menus
+	//Workers run at the lowest OS priority, pause mid-song when gameplay starts and keep their place on disk
+	class LibraryScheduler
+	{
+		public:
+			struct Statistics
+			{
+				size_t Songs = 0;
+				//Includes songs finished in earlier runs
+				size_t Done = 0;
+				size_t Failed = 0;
+			};
+
+			static LibraryScheduler& Get();
+
+			//Restarts the workers when anything changed, no folders or 0 cores stops them
+			void Configure(const std::vector<std::string>& folders, const OnSetOptions& options,
+				int frameSize, int sampleRate, unsigned int cores);
+			//Workers stop at their next progress check and hold their place
+			void Pause();
+			void Resume();
+			void Stop();
+
+			Statistics GetStats() const;
+
+		private:
+			LibraryScheduler() = default;
+			~LibraryScheduler();
+
+			void Work();
+			//Blocks while paused, false once stopping
+			bool Wait();
+			void Walk();
+			bool Next(SongEntry& song);
+			void Finish(const SongEntry& song, bool analysed);
+
+			void LoadProgress();
+			//Writes progress if songs finished since the last write, never under Lock
+			void Flush();
+			void SaveProgress(const std::vector<std::string>& finished) const;
+			//Path, size and modification time, an edited song is analysed again
+			static std::string GetSongId(const SongEntry& song);
+
+			std::vector<std::thread> Workers;
+			mutable std::mutex Lock;
+			std::condition_variable Wake;
+			std::atomic<bool> Running = false;
+			bool Paused = false;
+
+			std::vector<std::string> Folders;
+			OnSetOptions Options = {};
+			int FrameSize = 0;
+			int SampleRate = 0;
+			unsigned int Cores = 0;
+
+			//Songs left to analyse, taken from the song library once by the first worker
+			std::vector<SongEntry> Pending;
+			bool Walked = false;
+			bool Walking = false;
+			std::unordered_set<std::string> Finished;
+			size_t Unsaved = 0;
+			//Serialises writes so an older snapshot never replaces a newer one
+			std::mutex SaveLock;
+
+			std::atomic<size_t> Songs = 0;
+			std::atomic<size_t> Done = 0;
+			std::atomic<size_t> Failed = 0;
+	};
+}
@@ -2,18 +2,14 @@
 
 namespace OnBeat
 {
-	Loader::Loader(LoaderFunction fn) : fn(fn)
+	Loader::Loader(LoaderFunction fn)
 	{
-		finished = !fn;
-		if (!finished)
-		{
-			InternalThread.parent = this;
-			thread = std::thread(InternalThread);
-		}
+		//An empty job still finishes so callers can treat both the same
+		Job = JobSystem::Get().Schedule(fn);
 	}
 
 	Loader::~Loader()
 	{
-		thread.join();
+		Job.Wait();
 	}
-}
\ No newline at end of file
+}
@@ -1,44 +1,28 @@
 #pragma once
+#include <OnBeat/Util/Jobs/Jobs.h>
 #include <functional>
-#include <thread>
 
 namespace OnBeat
 {
 
-	typedef std::function<void()> LoaderFunction;
+	typedef std::function<void(JobHandle&)> LoaderFunction;
 	typedef std::function<void()> LoaderCallback;
 
+	//Runs fn as one job on the shared pool, the job reports progress and checks for cancellation
 	class Loader
 	{
 		public:
 			Loader(LoaderFunction fn);
 			~Loader();
 
-			bool GetFinished() { return finished; }
+			bool GetFinished() const { return Job.GetFinished(); }
+			float GetProgress() const { return Job.GetProgress(); }
 
-		protected:
-			LoaderFunction fn;
-		
-		private:
-			struct
-			{
-				void operator()()
-				{
-					if (parent->fn)
-					{
-						parent->fn();
-						parent->finished = true;
-					}
-				};
-
-				Loader* parent;
-				
-			} InternalThread;
-
-			bool finished;
+			//Asks the job to stop, it returns at its next check
+			void Cancel() { Job.Cancel(); }
+			void Wait() const { Job.Wait(); }
 
-			std::thread thread;
-
-			friend class InternalThread;
+		protected:
+			JobHandle Job;
 	};
-}
\ No newline at end of file
+}
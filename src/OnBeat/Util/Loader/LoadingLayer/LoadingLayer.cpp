@@ -2,6 +2,7 @@
 #include <OnBeat/App/App.h>
 #include <Hazel/Renderer/RenderCommand.h>
 #include <Hazel/Renderer/Renderer2D.h>
+#include <algorithm>
 
 namespace OnBeat
 {
@@ -19,9 +20,11 @@ namespace OnBeat
 
 	bool LoadingLayer::OnResize(Hazel::WindowResizeEvent& e)
 	{
+		skin.Resolve((float)e.GetWidth(), (float)e.GetHeight());
+
 		//Redefine loading bar bounds
-		AnimationConfig.lower = (e.GetWidth() / (double)-210) + skin.LoadingAnimation.getScaleX();
-		AnimationConfig.upper = (e.GetWidth() / (double)210) - skin.LoadingAnimation.getScaleX();
+		AnimationConfig.lower = e.GetWidth() / (double)-210;
+		AnimationConfig.upper = e.GetWidth() / (double)210;
 		return false;
 	}
 
@@ -64,20 +67,15 @@ namespace OnBeat
 		skin.BackgroundTexture.draw(-0.5f);
 
 
-		//Calculate bar location
-		//Flip the velocity direction when out of bounds
-		if (AnimationConfig.oldX < AnimationConfig.lower)
-		{
-			AnimationConfig.velocity *= -1;
-			AnimationConfig.oldX = (float)AnimationConfig.lower;
-		}
-		if (AnimationConfig.oldX > AnimationConfig.upper)
-		{
-			AnimationConfig.velocity *= -1;
-			AnimationConfig.oldX = (float)AnimationConfig.upper;
-		}
-		skin.LoadingAnimation.draw(1.0f, (AnimationConfig.oldX + (float)(AnimationConfig.velocity * s)));
-		AnimationConfig.oldX += (float)(AnimationConfig.velocity * s);
+		//Ease towards the reported progress, it arrives in steps from the job
+		AnimationConfig.Shown += (GetProgress() - AnimationConfig.Shown) * std::min(1.0f, s * 10.0f);
+
+		float width = (float)(AnimationConfig.upper - AnimationConfig.lower) * AnimationConfig.Shown;
+		if (width <= 0.0f)
+			return;
+		skin.LoadingAnimation.Command.Draw(
+			{ (float)AnimationConfig.lower + width / 2.0f, skin.LoadingAnimation.getY(), 1.0f },
+			{ width, skin.LoadingAnimation.getScaleY() });
 	}
 
 
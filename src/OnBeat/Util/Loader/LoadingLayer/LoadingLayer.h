@@ -3,7 +3,7 @@
 #include <OnBeat/Util/Loader/Loader.h>
 #include <OnBeat/Config/Skin.h>
 
-#define BindLoadingFunction(fn) (OnBeat::LoaderFunction)std::bind(fn, this)
+#define BindLoadingFunction(fn) (OnBeat::LoaderFunction)std::bind(fn, this, std::placeholders::_1)
 #define BindLoadingCallback(fn) (OnBeat::LoaderCallback)std::bind(fn, this)
 
 namespace OnBeat
@@ -27,10 +27,10 @@ namespace OnBeat
 			bool visible;
 
 			Skin::LoadingSkin skin;
+			//Bar fills from left to right with the job's progress
 			struct
 			{
-				double velocity = 4;
-				float oldX = 0.0f;
+				float Shown = 0.0f;
 				double lower;
 				double upper;
 			} AnimationConfig;
@@ -0,0 +1,158 @@
+#include <OnBeat/Util/OnSetDetection/AnalysisCache/AnalysisCache.h>
+#include <OnBeat/Util/FNV/FNV.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace OnBeat
+{
+	static const uint32_t Magic = 0x4341424F; //"OBAC"
+	template<typename T>
+	static uint64_t Add(uint64_t hash, const T& value)
+	{
+		return FNV::Hash(hash, value);
+	}
+
+	uint64_t AnalysisCache::Hash(uint64_t content, const OnSetOptions& options, int frameSize)
+	{
+		//Fields one at a time, struct padding is not guaranteed to be zeroed
+		uint64_t hash = content;
+		hash = Add(hash, options.ThresholdConstant);
+		hash = Add(hash, options.ThresholdMultiple);
+		hash = Add(hash, options.MeanWindow);
+		hash = Add(hash, options.MaximaWindow);
+		hash = Add(hash, options.Mode);
+		hash = Add(hash, options.Percussive);
+		hash = Add(hash, options.MedianWindow);
+		hash = Add(hash, options.Bands);
+		hash = Add(hash, frameSize);
+		return Add(hash, OB_ANALYSIS_CACHE_VERSION);
+	}
+
+	uint64_t AnalysisCache::Hash(const std::string& file, const OnSetOptions& options, int frameSize)
+	{
+		uint64_t content = FNV::File(file);
+		return content ? Hash(content, options, frameSize) : 0;
+	}
+
+	uint64_t AnalysisCache::HashOptions(const OnSetOptions& options, int frameSize)
+	{
+		return Hash(FNV::Offset, options, frameSize);
+	}
+
+	std::string AnalysisCache::GetPath(uint64_t hash)
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.onset", (unsigned long long)hash);
+		return std::string(OB_ANALYSIS_CACHE) + "/" + name;
+	}
+
+	static void WriteVector(std::ofstream& output, const AudioVector& vector)
+	{
+		uint32_t channels = (uint32_t)vector.size();
+		output.write((const char*)&channels, sizeof(channels));
+		for (auto& channel : vector)
+		{
+			uint64_t size = channel.size();
+			output.write((const char*)&size, sizeof(size));
+			output.write((const char*)channel.data(), size * sizeof(double));
+		}
+	}
+
+	static bool ReadVector(std::ifstream& input, AudioVector& vector)
+	{
+		uint32_t channels = 0;
+		if (!input.read((char*)&channels, sizeof(channels)) || channels > 1024)
+			return false;
+
+		vector.assign(channels, {});
+		for (auto& channel : vector)
+		{
+			uint64_t size = 0;
+			if (!input.read((char*)&size, sizeof(size)) || size > (1ull << 32))
+				return false;
+			channel.resize(size);
+			if (!input.read((char*)channel.data(), size * sizeof(double)))
+				return false;
+		}
+		return true;
+	}
+
+	bool AnalysisCache::Load(uint64_t hash, AnalysisResult& result)
+	{
+		if (!hash)
+			return false;
+
+		std::ifstream input(GetPath(hash), std::ios::binary);
+		if (!input)
+			return false;
+
+		uint32_t magic = 0, version = 0;
+		input.read((char*)&magic, sizeof(magic));
+		input.read((char*)&version, sizeof(version));
+		if (!input || magic != Magic || version != OB_ANALYSIS_CACHE_VERSION)
+			return false;
+
+		return input.read((char*)&result.SoundBytes, sizeof(result.SoundBytes)) &&
+			ReadVector(input, result.Odf) && ReadVector(input, result.Peaks);
+	}
+
+	bool AnalysisCache::Store(uint64_t hash, const AnalysisResult& result)
+	{
+		if (!hash)
+			return false;
+
+		std::error_code error;
+		std::filesystem::create_directories(OB_ANALYSIS_CACHE, error);
+
+		std::string path = GetPath(hash);
+		std::string temporary = path + ".tmp";
+		{
+			std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+			if (!output)
+				return false;
+
+			uint32_t version = OB_ANALYSIS_CACHE_VERSION;
+			output.write((const char*)&Magic, sizeof(Magic));
+			output.write((const char*)&version, sizeof(version));
+			output.write((const char*)&result.SoundBytes, sizeof(result.SoundBytes));
+			WriteVector(output, result.Odf);
+			WriteVector(output, result.Peaks);
+			if (!output)
+				return false;
+		}
+
+		std::filesystem::rename(temporary, path, error);
+		if (error)
+		{
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+		return true;
+	}
+
+	bool AnalysisCache::Analyse(const std::string& file, const OnSetOptions& options, int frameSize, int sampleRate,
+		AnalysisResult& result, const OnSetProgress& progress, uint64_t content)
+	{
+		uint64_t hash = content ? Hash(content, options, frameSize) : Hash(file, options, frameSize);
+		if (Load(hash, result))
+			return !result.Peaks.empty();
+
+		OnSetDetection generator(options, "", frameSize, sampleRate);
+		result.Odf = generator.ProcessFile(file, progress);
+		if (result.Odf.empty())
+			return false;
+		result.Peaks = generator.FindBeats(result.Odf);
+		if (result.Peaks.empty())
+			return false;
+
+		const AudioVector& samples = generator.GetAudioFile().GetSamples();
+		result.SoundBytes = samples.empty() ? 0 : samples.size() * samples[0].size() * sizeof(int16_t);
+
+		//A failed write only costs the analysis again next time
+		Store(hash, result);
+		return true;
+	}
+}
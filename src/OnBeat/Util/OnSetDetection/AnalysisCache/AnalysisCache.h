@@ -0,0 +1,42 @@
+#pragma once
+#include <OnBeat/Util/OnSetDetection/OnSetDetection.h>
+#include <cstdint>
+#include <string>
+
+#define OB_ANALYSIS_CACHE "assets/user/cache"
+//Bumped whenever the analysis or the file layout changes so stale results are never read
+#define OB_ANALYSIS_CACHE_VERSION 1
+
+namespace OnBeat
+{
+	//Slow part of a song's analysis, everything after it is cheap enough to redo on load
+	struct AnalysisResult
+	{
+		AudioVector Odf;
+		AudioVector Peaks;
+		//16 bit PCM the decoded song takes, so the session cache can budget for it without decoding
+		uint64_t SoundBytes = 0;
+	};
+
+	//Analysis results on disk, one file per song content and options
+	//Files are written to a temporary name and renamed so a crash never leaves half a result
+	class AnalysisCache
+	{
+		public:
+			//FNV::File of the song extended with the options and the frame size, 0 when the file cannot be read
+			static uint64_t Hash(const std::string& file, const OnSetOptions& options, int frameSize);
+			//Same key from a content hash already taken, such as SongEntry::Hash
+			static uint64_t Hash(uint64_t content, const OnSetOptions& options, int frameSize);
+			//The options part of Hash on its own
+			static uint64_t HashOptions(const OnSetOptions& options, int frameSize);
+			static std::string GetPath(uint64_t hash);
+
+			static bool Load(uint64_t hash, AnalysisResult& result);
+			static bool Store(uint64_t hash, const AnalysisResult& result);
+
+			//Reads the result from disk or runs the analysis and writes it
+			//False when progress cancels it or the file has no onsets, a content hash of 0 reads the file for one
+			static bool Analyse(const std::string& file, const OnSetOptions& options, int frameSize, int sampleRate,
+				AnalysisResult& result, const OnSetProgress& progress = nullptr, uint64_t content = 0);
+	};
+}
@@ -0,0 +1,100 @@
+#include <OnBeat/Util/OnSetDetection/FFT/FFT.h>
+#include <algorithm>
+
+namespace OnBeat
+{
+	namespace FFT
+	{
+		size_t nextPowerOfTwo(size_t n)
+		{
+			size_t p = 1;
+			while (p < n)
+			{
+				p <<= 1;
+			}
+			return p;
+		}
+
+		void transform(std::vector<std::complex<double>>& data, bool inverse)
+		{
+			const size_t n = data.size();
+			if (n < 2)
+			{
+				return;
+			}
+
+			//Bit reversal permutation
+			for (size_t i = 1, j = 0; i < n; i++)
+			{
+				size_t bit = n >> 1;
+				for (; j & bit; bit >>= 1)
+				{
+					j ^= bit;
+				}
+				j ^= bit;
+
+				if (i < j)
+				{
+					std::swap(data[i], data[j]);
+				}
+			}
+
+			//Butterflies
+			const double pi = 3.14159265358979323846;
+			for (size_t len = 2; len <= n; len <<= 1)
+			{
+				double angle = 2 * pi / len * (inverse ? 1 : -1);
+				std::complex<double> wLen(std::cos(angle), std::sin(angle));
+				for (size_t i = 0; i < n; i += len)
+				{
+					std::complex<double> w(1);
+					for (size_t k = 0; k < len / 2; k++)
+					{
+						std::complex<double> u = data[i + k];
+						std::complex<double> v = data[i + k + len / 2] * w;
+						data[i + k] = u + v;
+						data[i + k + len / 2] = u - v;
+						w *= wLen;
+					}
+				}
+			}
+
+			if (inverse)
+			{
+				for (auto& value : data)
+				{
+					value /= (double)n;
+				}
+			}
+		}
+
+		std::vector<double> autocorrelate(const std::vector<double>& signal, size_t maxLag)
+		{
+			if (signal.empty())
+			{
+				return {};
+			}
+
+			//Zero pad to twice the length to avoid circular wrap around
+			size_t size = nextPowerOfTwo(signal.size() * 2);
+			std::vector<std::complex<double>> spectrum(size);
+			std::copy(signal.begin(), signal.end(), spectrum.begin());
+
+			transform(spectrum);
+			for (auto& value : spectrum)
+			{
+				value = std::norm(value);
+			}
+			transform(spectrum, true);
+
+			maxLag = std::min(maxLag, signal.size() - 1);
+			std::vector<double> lags;
+			lags.reserve(maxLag + 1);
+			for (size_t lag = 0; lag <= maxLag; lag++)
+			{
+				lags.push_back(spectrum[lag].real());
+			}
+			return lags;
+		}
+	}
+}
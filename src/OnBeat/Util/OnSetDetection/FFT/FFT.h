@@ -0,0 +1,18 @@
+#pragma once
+#include <complex>
+#include <vector>
+
+namespace OnBeat
+{
+	namespace FFT
+	{
+		//Smallest power of two greater than or equal to n
+		size_t nextPowerOfTwo(size_t n);
+
+		//In place iterative radix-2 transform, data size must be a power of two
+		void transform(std::vector<std::complex<double>>& data, bool inverse = false);
+
+		//Autocorrelation of a real signal for lags [0, maxLag] in O(n log n)
+		std::vector<double> autocorrelate(const std::vector<double>& signal, size_t maxLag);
+	}
+}
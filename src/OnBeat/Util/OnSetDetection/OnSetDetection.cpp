@@ -1,11 +1,74 @@
 #define MINIMP3_IMPLEMENTATION
 
 #include <OnBeat/Util/OnSetDetection/OnSetDetection.h>
+#include <OnBeat/Util/OnSetDetection/FFT/FFT.h>
+#include <OnBeat/Util/OnSetDetection/Spectrogram/Spectrogram.h>
 #include <OnBeat/Util/AppUtil/AppUtil.h>
 #include <filesystem>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OB_SSE2
+#endif
 
 namespace OnBeat
 {
+	//Absolute difference of two spectra summed per band
+	static void bandDifference(const double* current, const double* previous,
+		const std::vector<size_t>& edges, double* output)
+	{
+		for (size_t band = 0; band + 1 < edges.size(); band++)
+		{
+			size_t n = edges[band];
+			size_t end = edges[band + 1];
+			double sum = 0;
+#ifdef OB_SSE2
+			const __m128d signMask = _mm_set1_pd(-0.0);
+			__m128d lanes = _mm_setzero_pd();
+			for (; n + 2 <= end; n += 2)
+			{
+				__m128d diff = _mm_sub_pd(_mm_loadu_pd(current + n), _mm_loadu_pd(previous + n));
+				lanes = _mm_add_pd(lanes, _mm_andnot_pd(signMask, diff));
+			}
+			double packed[2];
+			_mm_storeu_pd(packed, lanes);
+			sum = packed[0] + packed[1];
+#endif
+			for (; n < end; n++)
+			{
+				sum += std::abs(current[n] - previous[n]);
+			}
+			output[band] = sum;
+		}
+	}
+
+	//Sum of squares over a frame, two doubles per lane pair
+	static double frameEnergy(const double* data, size_t size)
+	{
+		size_t n = 0;
+		double energy = 0;
+#ifdef OB_SSE2
+		__m128d sumA = _mm_setzero_pd();
+		__m128d sumB = _mm_setzero_pd();
+		for (; n + 4 <= size; n += 4)
+		{
+			__m128d a = _mm_loadu_pd(data + n);
+			__m128d b = _mm_loadu_pd(data + n + 2);
+			sumA = _mm_add_pd(sumA, _mm_mul_pd(a, a));
+			sumB = _mm_add_pd(sumB, _mm_mul_pd(b, b));
+		}
+		double lanes[2];
+		_mm_storeu_pd(lanes, _mm_add_pd(sumA, sumB));
+		energy = lanes[0] + lanes[1];
+#endif
+		for (; n < size; n++)
+		{
+			energy += data[n] * data[n];
+		}
+		return energy;
+	}
 
 	OnSetFile::OnSetFile()
 	{
@@ -201,6 +264,214 @@ namespace OnBeat
 		return sum / size;
 	}
 
+	std::vector<size_t> OnSetDetection::FindBandEdges(size_t bins, int bands)
+	{
+		//Skip the DC bin and grow each edge by at least one bin
+		//Bands past the last bin are merged into the top one rather than left empty
+		std::vector<size_t> edges{ std::min<size_t>(1, bins) };
+		for (int n = 1; n <= bands && edges.back() < bins; n++)
+		{
+			size_t edge = (size_t)std::round(std::pow((double)bins, (double)n / bands));
+			edges.push_back(std::min(bins, std::max(edge, edges.back() + 1)));
+		}
+		return edges;
+	}
+
+	TempoEstimate OnSetDetection::EstimateTempo(const AudioVector& odf, double frameRate,
+		double minBpm, double maxBpm)
+	{
+		TempoEstimate tempo;
+		if (odf.empty() || odf[0].empty() || frameRate <= 0)
+		{
+			return tempo;
+		}
+
+		//Mix channels down and remove the mean so silence does not dominate the correlation
+		size_t length = odf[0].size();
+		for (auto& channel : odf)
+		{
+			length = std::min(length, channel.size());
+		}
+
+		std::vector<double> signal(length, 0.0);
+		for (auto& channel : odf)
+		{
+			for (size_t n = 0; n < length; n++)
+			{
+				signal[n] += channel[n];
+			}
+		}
+
+		double mean = 0;
+		for (auto& value : signal)
+		{
+			mean += value;
+		}
+		mean /= (double)length;
+		for (auto& value : signal)
+		{
+			value = std::max(0.0, value - mean);
+		}
+
+		size_t minLag = (size_t)std::max(1.0, std::floor(frameRate * 60.0 / maxBpm));
+		size_t maxLag = (size_t)std::ceil(frameRate * 60.0 / minBpm);
+		//Double range so the half tempo harmonic can be checked
+		std::vector<double> correlation = FFT::autocorrelate(signal, maxLag * 2);
+		if (correlation.size() <= minLag + 1 || correlation[0] <= 0)
+		{
+			return tempo;
+		}
+		maxLag = std::min(maxLag, correlation.size() - 2);
+
+		//Score each lag with its first harmonic and a log-gaussian prior around 120bpm
+		size_t bestLag = minLag;
+		double bestScore = -1;
+		for (size_t lag = minLag; lag <= maxLag; lag++)
+		{
+			double harmonic = (lag * 2 < correlation.size()) ? correlation[lag * 2] : 0;
+			double bpm = frameRate * 60.0 / lag;
+			double prior = std::exp(-0.5 * std::pow(std::log2(bpm / 120.0), 2));
+			double score = (correlation[lag] + 0.5 * harmonic) * prior;
+			if (score > bestScore)
+			{
+				bestScore = score;
+				bestLag = lag;
+			}
+		}
+
+		//Parabolic interpolation for a fractional period
+		double period = (double)bestLag;
+		if (bestLag > minLag && bestLag < maxLag)
+		{
+			double a = correlation[bestLag - 1];
+			double b = correlation[bestLag];
+			double c = correlation[bestLag + 1];
+			double denominator = a - 2 * b + c;
+			if (denominator != 0)
+			{
+				period += std::clamp(0.5 * (a - c) / denominator, -0.5, 0.5);
+			}
+		}
+
+		//Beat phase from a comb over the mixed onset function
+		int phaseCount = (int)std::ceil(period);
+		int bestPhase = 0;
+		double bestPhaseScore = -1;
+		for (int phase = 0; phase < phaseCount; phase++)
+		{
+			double sum = 0;
+			for (double n = phase; n < length; n += period)
+			{
+				sum += signal[(size_t)n];
+			}
+			if (sum > bestPhaseScore)
+			{
+				bestPhaseScore = sum;
+				bestPhase = phase;
+			}
+		}
+
+		tempo.Bpm = frameRate * 60.0 / period;
+		tempo.Offset = bestPhase / frameRate;
+		tempo.Confidence = correlation[bestLag] / correlation[0];
+		return tempo;
+	}
+
+	AudioVector OnSetDetection::QuantiseBeats(const AudioVector& beats, const TempoEstimate& tempo,
+		double frameRate, int division)
+	{
+		if (division <= 0 || tempo.Bpm <= 0)
+		{
+			return beats;
+		}
+
+		double step = frameRate * 60.0 / tempo.Bpm / division;
+		double phase = tempo.Offset * frameRate;
+
+		AudioVector quantised;
+		quantised.reserve(beats.size());
+		for (auto& channel : beats)
+		{
+			std::vector<double> snapped(channel.size(), 0.0);
+			for (size_t n = 0; n < channel.size(); n++)
+			{
+				if (channel[n] == 0)
+				{
+					continue;
+				}
+
+				//Onsets landing on the same grid point collapse to the strongest
+				long long target = std::llround(phase + std::round((n - phase) / step) * step);
+				target = std::clamp(target, 0LL, (long long)channel.size() - 1);
+				snapped[target] = std::max(snapped[target], channel[n]);
+			}
+			quantised.push_back(std::move(snapped));
+		}
+
+		return quantised;
+	}
+
+	std::vector<AudioVector> OnSetDetection::SelectDifficulties(const AudioVector& beats, double frameRate,
+		const std::vector<double>& maxNotesPerSecond)
+	{
+		struct Onset
+		{
+			double strength;
+			size_t channel;
+			size_t frame;
+		};
+
+		//One strength sorted list shared by every level
+		std::vector<Onset> onsets;
+		size_t length = 0;
+		for (size_t c = 0; c < beats.size(); c++)
+		{
+			length = std::max(length, beats[c].size());
+			for (size_t n = 0; n < beats[c].size(); n++)
+			{
+				if (beats[c][n] != 0)
+				{
+					onsets.push_back({ beats[c][n], c, n });
+				}
+			}
+		}
+		std::stable_sort(onsets.begin(), onsets.end(), [](const Onset& a, const Onset& b)
+			{
+				return a.strength > b.strength;
+			}
+		);
+
+		std::vector<AudioVector> levels;
+		std::vector<std::vector<int>> counts;
+		size_t seconds = (size_t)(length / std::max(frameRate, 1.0)) + 1;
+		for (size_t l = 0; l < maxNotesPerSecond.size(); l++)
+		{
+			AudioVector level;
+			for (auto& channel : beats)
+			{
+				level.push_back(std::vector<double>(channel.size(), 0.0));
+			}
+			levels.push_back(std::move(level));
+			counts.push_back(std::vector<int>(seconds, 0));
+		}
+
+		//Greedy fill of each one second bucket up to the level density
+		for (auto& onset : onsets)
+		{
+			size_t second = std::min((size_t)(onset.frame / frameRate), seconds - 1);
+			for (size_t l = 0; l < levels.size(); l++)
+			{
+				if (counts[l][second] < maxNotesPerSecond[l])
+				{
+					counts[l][second]++;
+					levels[l][onset.channel][onset.frame] = onset.strength;
+				}
+			}
+		}
+
+		return levels;
+	}
+
 	AudioVector OnSetDetection::FindBeats(const AudioVector& beats)
 	{
 		AudioVector beatPoints;
@@ -265,17 +536,44 @@ namespace OnBeat
 		return beatPoints;
 	}
 
-	AudioVector OnSetDetection::ProcessAudioVector(const AudioVector& data)
+	AudioVector OnSetDetection::ProcessAudioVector(const AudioVector& data, const OnSetProgress& progress)
 	{
+		if (options.Mode == OnSetMode::Energy)
+		{
+			return ProcessEnergyVector(data, progress);
+		}
+
 		AudioVector values;
 		values.reserve(data.size());
 		//Allocate framesize
 		std::vector<double> frame;
 		frame.reserve(getAudioFrameSize());
+
+		//Multi-band output is one ODF per band with channels summed
+		bool banded = options.Bands > 0;
+		AudioVector bandValues(banded ? options.Bands : 0);
+		std::vector<size_t> edges;
+		std::vector<double> previous, bandFrame(banded ? options.Bands : 0);
+		//Short spectra can have fewer bins than bands asked for
+		int bandCount = options.Bands;
+
+		size_t totalFrames = 0, doneFrames = 0;
+		for (auto& channel : data)
+		{
+			totalFrames += channel.empty() ? 0 : (channel.size() - 1) / getAudioFrameSize();
+		}
+
 		//Processing channels
 		for (int c = 0; c < data.size(); c++)
 		{
 			values.push_back(frame);
+
+			//Percussive separation needs the whole spectrogram before differencing
+			size_t frameCount = data[c].empty() ? 0 : (data[c].size() - 1) / getAudioFrameSize();
+			size_t frameIndex = 0;
+			Spectrogram spectrogram;
+			previous.clear();
+
 			//Loop through each frame
 			for (int i = getAudioFrameSize(); i < data[c].size(); i += getAudioFrameSize())
 			{
@@ -286,17 +584,123 @@ namespace OnBeat
 
 				processAudioFrame(frame);
 
-				values[c].push_back(spectralDifference());
+				if (options.Percussive)
+				{
+					const std::vector<double>& magnitudes = getMagnitudeSpectrum();
+					if (spectrogram.GetBins() == 0)
+					{
+						spectrogram = Spectrogram(frameCount, magnitudes.size());
+					}
+					spectrogram.SetFrame(frameIndex++, magnitudes);
+				}
+				else if (banded)
+				{
+					//Bands come from the same FFT as the full spectral difference
+					const std::vector<double>& magnitudes = getMagnitudeSpectrum();
+					if (previous.empty())
+					{
+						edges = FindBandEdges(magnitudes.size(), options.Bands);
+						bandCount = (int)edges.size() - 1;
+						previous.assign(magnitudes.size(), 0.0);
+					}
+					bandDifference(magnitudes.data(), previous.data(), edges, bandFrame.data());
+					previous = magnitudes;
+
+					for (int b = 0; b < bandCount; b++)
+					{
+						if (bandValues[b].size() <= frameIndex)
+						{
+							bandValues[b].push_back(0);
+						}
+						bandValues[b][frameIndex] += bandFrame[b];
+					}
+					frameIndex++;
+				}
+				else
+				{
+					values[c].push_back(spectralDifference());
+				}
 				frame.clear();
+
+				if (progress && ++doneFrames % OB_ONSET_PROGRESS_FRAMES == 0 &&
+					!progress((double)doneFrames / totalFrames))
+				{
+					return {};
+				}
+			}
+
+			if (options.Percussive && spectrogram.GetFrames() != 0)
+			{
+				Spectrogram percussive = spectrogram.Percussive(options.MedianWindow, options.MedianWindow);
+				if (banded)
+				{
+					AudioVector bands = percussive.BandDifference(FindBandEdges(percussive.GetBins(), options.Bands));
+					bandCount = (int)bands.size();
+					for (int b = 0; b < bandCount; b++)
+					{
+						bandValues[b].resize(std::max(bandValues[b].size(), bands[b].size()), 0.0);
+						for (size_t n = 0; n < bands[b].size(); n++)
+						{
+							bandValues[b][n] += bands[b][n];
+						}
+					}
+				}
+				else
+				{
+					values[c] = percussive.SpectralDifference();
+				}
 			}
 		}
 
+		if (banded)
+		{
+			bandValues.resize(bandCount);
+			return OnSetDetection::Normalise(bandValues);
+		}
+
 		//All frames processed in both channels
 		return OnSetDetection::Normalise(values);
 
 	}
 
-	AudioVector OnSetDetection::ProcessFile(const std::string& file)
+	AudioVector OnSetDetection::ProcessEnergyVector(const AudioVector& data, const OnSetProgress& progress)
+	{
+		AudioVector values;
+		values.reserve(data.size());
+
+		int frameSize = getAudioFrameSize();
+		size_t totalFrames = 0, doneFrames = 0;
+		for (auto& channel : data)
+		{
+			totalFrames += channel.size() / frameSize;
+		}
+
+		for (auto& channel : data)
+		{
+			std::vector<double> odf;
+			odf.reserve(channel.size() / frameSize);
+
+			//Same framing as the spectral path so peak picking and timing line up
+			double previous = 0;
+			for (size_t i = frameSize; i < channel.size(); i += frameSize)
+			{
+				double energy = std::log1p(frameEnergy(channel.data() + i - frameSize, frameSize));
+				odf.push_back(std::max(0.0, energy - previous));
+				previous = energy;
+
+				if (progress && ++doneFrames % OB_ONSET_PROGRESS_FRAMES == 0 &&
+					!progress((double)doneFrames / totalFrames))
+				{
+					return {};
+				}
+			}
+			values.push_back(std::move(odf));
+		}
+
+		return OnSetDetection::Normalise(values);
+	}
+
+	AudioVector OnSetDetection::ProcessFile(const std::string& file, const OnSetProgress& progress)
 	{
 		if (std::filesystem::exists(file))
 		{
@@ -311,7 +715,7 @@ namespace OnBeat
 		}
 
 		//All frames processed in both channels
-		return ProcessAudioVector(AudioFile.GetSamples());
+		return ProcessAudioVector(AudioFile.GetSamples(), progress);
 	}
 
 	OnSetDetection::~OnSetDetection()
@@ -2,20 +2,10 @@
 #include <AudioFile/AudioFile.h>
 #include <minimp3/minimp3_ex.h>
 #include <Gist.h>
+#include <OnBeat/Util/OnSetDetection/OnSetOptions.h>
 
 
 namespace OnBeat {
-	//Define AudioVector as a 2d vector of doubles
-	typedef std::vector<std::vector<double>> AudioVector;
-
-	struct OnSetOptions
-	{
-		double ThresholdConstant;
-		double ThresholdMultiple;
-		int MeanWindow;
-		int MaximaWindow;
-	};
-
 	enum class OnSetFormat
 	{
 		Error,
@@ -73,14 +63,29 @@ namespace OnBeat {
 			static AudioVector ValidateAudioVector(const AudioVector& beats);
 			static int CreateBeatFile(const AudioVector& beats, const std::string& outputFile, int frameSize = 512, double sampleRate = 44100);
 			static double FindPeakThreshold(const std::vector<double>& beats);
+			//Log spaced bin boundaries for multi-band analysis
+			static std::vector<size_t> FindBandEdges(size_t bins, int bands);
+
+			//Tempo and beat phase from onset detection function autocorrelation
+			static TempoEstimate EstimateTempo(const AudioVector& odf, double frameRate,
+				double minBpm = 60, double maxBpm = 200);
+			//Thin one peak set into a chart per density, strongest onsets first
+			static std::vector<AudioVector> SelectDifficulties(const AudioVector& beats, double frameRate,
+				const std::vector<double>& maxNotesPerSecond);
+			//Snap peaks to the nearest point on the estimated beat grid
+			static AudioVector QuantiseBeats(const AudioVector& beats, const TempoEstimate& tempo,
+				double frameRate, int division);
 
 
 			//Peak detection algorithm
 			AudioVector FindBeats(const AudioVector& beats);
 
 			//Gist onset detection of a .wav file using spectralDifference
-			AudioVector ProcessFile(const std::string& file = "");
-			AudioVector ProcessAudioVector(const AudioVector& data);
+			//All return an empty vector when progress cancels them
+			AudioVector ProcessFile(const std::string& file = "", const OnSetProgress& progress = nullptr);
+			AudioVector ProcessAudioVector(const AudioVector& data, const OnSetProgress& progress = nullptr);
+			//Rectified energy difference per frame, a fraction of the spectral cost
+			AudioVector ProcessEnergyVector(const AudioVector& data, const OnSetProgress& progress = nullptr);
 
 			//Get private values
 			const OnSetOptions& GetOptions() const { return options; }
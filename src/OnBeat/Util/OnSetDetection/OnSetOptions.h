@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace OnBeat {
+	//Define AudioVector as a 2d vector of doubles
+	typedef std::vector<std::vector<double>> AudioVector;
+
+	enum class OnSetMode
+	{
+		//Gist spectral difference, full quality
+		Spectral,
+		//Time domain energy difference, no FFT, used for previews
+		Energy
+	};
+
+	struct OnSetOptions
+	{
+		double ThresholdConstant;
+		double ThresholdMultiple;
+		int MeanWindow;
+		int MaximaWindow;
+		//Beats per estimated tempo beat to snap onsets to, 0 disables quantisation
+		int GridDivision = 0;
+		OnSetMode Mode = OnSetMode::Spectral;
+		//Median filter the spectrogram and only difference the percussive part
+		bool Percussive = false;
+		int MedianWindow = 17;
+		//Split each spectrum into log spaced bands, one ODF per band, 0 gives one ODF per channel
+		int Bands = 0;
+	};
+
+	enum class Difficulty
+	{
+		Easy,
+		Normal,
+		Hard,
+		Expert
+	};
+
+	//Called with 0 to 1 as analysis runs, returning false stops it early
+	typedef std::function<bool(double)> OnSetProgress;
+
+	//Frames analysed between progress reports
+	#define OB_ONSET_PROGRESS_FRAMES 256
+
+	//Maximum notes per second allowed at each Difficulty
+	inline const std::array<double, 4> DifficultyDensity = { 2.0, 4.0, 7.0, 12.0 };
+
+	struct TempoEstimate
+	{
+		double Bpm = 0;
+		//Seconds from the start of the file to the first beat of the grid
+		double Offset = 0;
+		//Normalised autocorrelation strength of the chosen period
+		double Confidence = 0;
+	};
+}
@@ -0,0 +1,160 @@
+#include <OnBeat/Util/OnSetDetection/Spectrogram/Spectrogram.h>
+#include <OnBeat/Util/Jobs/Jobs.h>
+#include <algorithm>
+#include <cmath>
+
+namespace OnBeat
+{
+	Spectrogram::Spectrogram(size_t frames, size_t bins)
+		: data(frames * bins, 0.0f), frames(frames), bins(bins)
+	{
+	}
+
+	void Spectrogram::SetFrame(size_t frame, const std::vector<double>& magnitudes)
+	{
+		size_t count = std::min(bins, magnitudes.size());
+		for (size_t b = 0; b < count; b++)
+		{
+			At(frame, b) = (float)magnitudes[b];
+		}
+	}
+
+	std::vector<float> Spectrogram::Transpose() const
+	{
+		return Transpose(data.data(), bins, frames);
+	}
+
+	std::vector<float> Spectrogram::Transpose(const float* input, size_t rows, size_t columns)
+	{
+		const size_t tile = 64;
+		std::vector<float> transposed(rows * columns);
+		for (size_t r0 = 0; r0 < rows; r0 += tile)
+		{
+			for (size_t c0 = 0; c0 < columns; c0 += tile)
+			{
+				size_t rEnd = std::min(r0 + tile, rows);
+				size_t cEnd = std::min(c0 + tile, columns);
+				for (size_t r = r0; r < rEnd; r++)
+				{
+					for (size_t c = c0; c < cEnd; c++)
+					{
+						transposed[c * rows + r] = input[r * columns + c];
+					}
+				}
+			}
+		}
+		return transposed;
+	}
+
+	void Spectrogram::SlidingMedian(const float* input, float* output, size_t size, int window)
+	{
+		if (size == 0)
+		{
+			return;
+		}
+
+		size_t half = (size_t)std::max(window / 2, 0);
+
+		//Sorted copy of the current window, updated by one insert and one erase per step
+		std::vector<float> sorted;
+		sorted.reserve(half * 2 + 1);
+		for (size_t n = 0; n < std::min(half, size); n++)
+		{
+			sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), input[n]), input[n]);
+		}
+
+		for (size_t n = 0; n < size; n++)
+		{
+			if (n + half < size)
+			{
+				float incoming = input[n + half];
+				sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), incoming), incoming);
+			}
+			if (n > half)
+			{
+				float outgoing = input[n - half - 1];
+				sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), outgoing));
+			}
+			output[n] = sorted[sorted.size() / 2];
+		}
+	}
+
+	void Spectrogram::ParallelRows(size_t rows, const std::function<void(size_t, size_t)>& fn)
+	{
+		//Runs inside the loading job, the pool is shared rather than spawning threads per pass
+		JobSystem::Get().ParallelFor(rows, fn);
+	}
+
+	Spectrogram Spectrogram::Percussive(int timeWindow, int frequencyWindow) const
+	{
+		//Harmonic estimate, median along time for each bin
+		Spectrogram harmonic(frames, bins);
+		ParallelRows(bins, [&](size_t start, size_t end)
+			{
+				for (size_t b = start; b < end; b++)
+				{
+					SlidingMedian(GetBin(b), harmonic.GetBin(b), frames, timeWindow);
+				}
+			}
+		);
+
+		//Percussive estimate, median along frequency for each frame
+		std::vector<float> frameMajor = Transpose();
+		std::vector<float> percussiveFrames(frames * bins);
+		ParallelRows(frames, [&](size_t start, size_t end)
+			{
+				for (size_t f = start; f < end; f++)
+				{
+					SlidingMedian(frameMajor.data() + f * bins, percussiveFrames.data() + f * bins, bins, frequencyWindow);
+				}
+			}
+		);
+		std::vector<float> percussive = Transpose(percussiveFrames.data(), frames, bins);
+
+		//Soft mask applied in place over the harmonic buffer, walked bin-major
+		ParallelRows(bins, [&](size_t start, size_t end)
+			{
+				for (size_t b = start; b < end; b++)
+				{
+					float* out = harmonic.GetBin(b);
+					const float* in = GetBin(b);
+					const float* per = percussive.data() + b * frames;
+					for (size_t f = 0; f < frames; f++)
+					{
+						float p = per[f];
+						float h = out[f];
+						float mask = (p * p) / (p * p + h * h + 1e-12f);
+						out[f] = in[f] * mask;
+					}
+				}
+			}
+		);
+
+		return harmonic;
+	}
+
+	std::vector<double> Spectrogram::SpectralDifference() const
+	{
+		return BandDifference({ 0, bins })[0];
+	}
+
+	std::vector<std::vector<double>> Spectrogram::BandDifference(const std::vector<size_t>& edges) const
+	{
+		std::vector<std::vector<double>> bands;
+		for (size_t n = 0; n + 1 < edges.size(); n++)
+		{
+			std::vector<double> odf(frames, 0.0);
+			for (size_t b = edges[n]; b < std::min(edges[n + 1], bins) && frames != 0; b++)
+			{
+				const float* bin = GetBin(b);
+				odf[0] += bin[0];
+				for (size_t f = 1; f < frames; f++)
+				{
+					odf[f] += std::abs(bin[f] - bin[f - 1]);
+				}
+			}
+			bands.push_back(std::move(odf));
+		}
+		return bands;
+	}
+}
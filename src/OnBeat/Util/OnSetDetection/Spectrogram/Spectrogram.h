@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include <functional>
+
+namespace OnBeat
+{
+	//Magnitude spectrogram stored bin-major so each bin's time series is contiguous
+	class Spectrogram
+	{
+		public:
+			Spectrogram(size_t frames = 0, size_t bins = 0);
+
+			void SetFrame(size_t frame, const std::vector<double>& magnitudes);
+
+			float* GetBin(size_t bin) { return data.data() + bin * frames; }
+			const float* GetBin(size_t bin) const { return data.data() + bin * frames; }
+			float& At(size_t frame, size_t bin) { return data[bin * frames + frame]; }
+			float At(size_t frame, size_t bin) const { return data[bin * frames + frame]; }
+
+			size_t GetFrames() const { return frames; }
+			size_t GetBins() const { return bins; }
+
+			//Frame-major copy for filtering along frequency
+			std::vector<float> Transpose() const;
+			//Row-major transpose in cache sized tiles
+			static std::vector<float> Transpose(const float* input, size_t rows, size_t columns);
+
+			//Harmonic/percussive separation by median filtering along time and frequency
+			//Returns the spectrogram with a soft percussive mask applied
+			Spectrogram Percussive(int timeWindow, int frequencyWindow) const;
+
+			//Sum of absolute magnitude change between consecutive frames
+			std::vector<double> SpectralDifference() const;
+			//Spectral difference summed separately over bins [edges[n], edges[n + 1])
+			std::vector<std::vector<double>> BandDifference(const std::vector<size_t>& edges) const;
+
+			//Median over a centered window, shrinking at the edges
+			static void SlidingMedian(const float* input, float* output, size_t size, int window);
+
+			//Split rows into contiguous blocks across the job pool
+			static void ParallelRows(size_t rows, const std::function<void(size_t, size_t)>& fn);
+
+		private:
+			std::vector<float> data;
+			size_t frames;
+			size_t bins;
+	};
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace OnBeat
+{
+	//Bounded lock free queue for any number of producer threads and one consumer thread
+	//Each slot carries a sequence number so producers claim slots without a lock
+	template<typename T, size_t Size>
+	class MPSCQueue
+	{
+		static_assert((Size & (Size - 1)) == 0, "MPSCQueue size must be a power of two");
+
+		public:
+			MPSCQueue()
+			{
+				for (size_t i = 0; i < Size; i++)
+				{
+					Slots[i].Sequence.store(i, std::memory_order_relaxed);
+				}
+			}
+
+			bool Push(const T& value)
+			{
+				size_t head = Head.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					Slot& slot = Slots[head & (Size - 1)];
+					ptrdiff_t diff = (ptrdiff_t)(slot.Sequence.load(std::memory_order_acquire) - head);
+					if (diff == 0)
+					{
+						if (Head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+						{
+							slot.Value = value;
+							slot.Sequence.store(head + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if (diff < 0)
+					{
+						//Consumer has not freed this slot yet
+						return false;
+					}
+					else
+					{
+						head = Head.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			bool Pop(T& value)
+			{
+				Slot& slot = Slots[Tail & (Size - 1)];
+				if (slot.Sequence.load(std::memory_order_acquire) != Tail + 1)
+				{
+					return false;
+				}
+				value = std::move(slot.Value);
+				slot.Sequence.store(Tail + Size, std::memory_order_release);
+				Tail++;
+				return true;
+			}
+
+		private:
+			struct Slot
+			{
+				std::atomic<size_t> Sequence;
+				T Value;
+			};
+
+			std::array<Slot, Size> Slots;
+			alignas(64) std::atomic<size_t> Head = 0;
+			//Only touched by the consumer
+			alignas(64) size_t Tail = 0;
+	};
+}
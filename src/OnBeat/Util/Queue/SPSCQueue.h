@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace OnBeat
+{
+	//Lock free ring buffer for exactly one producer thread and one consumer thread
+	//Size must be a power of two, one slot is kept free to tell full from empty
+	template<typename T, size_t Size>
+	class SPSCQueue
+	{
+		static_assert((Size & (Size - 1)) == 0, "SPSCQueue size must be a power of two");
+
+		public:
+			bool Push(const T& value)
+			{
+				size_t head = Head.load(std::memory_order_relaxed);
+				size_t next = (head + 1) & (Size - 1);
+				if (next == Tail.load(std::memory_order_acquire))
+				{
+					return false;
+				}
+				Buffer[head] = value;
+				Head.store(next, std::memory_order_release);
+				return true;
+			}
+
+			bool Pop(T& value)
+			{
+				size_t tail = Tail.load(std::memory_order_relaxed);
+				if (tail == Head.load(std::memory_order_acquire))
+				{
+					return false;
+				}
+				value = Buffer[tail];
+				Tail.store((tail + 1) & (Size - 1), std::memory_order_release);
+				return true;
+			}
+
+			bool Empty() const
+			{
+				return Tail.load(std::memory_order_acquire) == Head.load(std::memory_order_acquire);
+			}
+
+		private:
+			std::array<T, Size> Buffer;
+			//Separate cache lines so the two threads do not false share
+			alignas(64) std::atomic<size_t> Head = 0;
+			alignas(64) std::atomic<size_t> Tail = 0;
+	};
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace OnBeat
+{
+	//Lock free latest value from one writer thread to any number of reader threads
+	//Readers copy the value and retry if the writer published during the copy, the writer never waits
+	template<typename T>
+	class SeqLock
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied a word at a time");
+
+		public:
+			SeqLock() { Publish(T{}); }
+
+			void Publish(const T& value)
+			{
+				std::array<uint64_t, Words> words{};
+				std::memcpy(words.data(), &value, sizeof(T));
+
+				uint64_t sequence = Sequence.load(std::memory_order_relaxed);
+				Sequence.store(sequence + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				for (size_t i = 0; i < Words; i++)
+				{
+					Data[i].store(words[i], std::memory_order_relaxed);
+				}
+				Sequence.store(sequence + 2, std::memory_order_release);
+			}
+
+			T Read() const
+			{
+				std::array<uint64_t, Words> words;
+				for (;;)
+				{
+					uint64_t sequence = Sequence.load(std::memory_order_acquire);
+					if (sequence & 1)
+						continue;
+					for (size_t i = 0; i < Words; i++)
+					{
+						words[i] = Data[i].load(std::memory_order_relaxed);
+					}
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (Sequence.load(std::memory_order_relaxed) == sequence)
+						break;
+				}
+
+				T value;
+				//Through void*, T may have default member initialisers and still be trivially copyable
+				std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+				return value;
+			}
+
+		private:
+			static constexpr size_t Words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+			std::atomic<uint64_t> Sequence = 0;
+			std::array<std::atomic<uint64_t>, Words> Data{};
+	};
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace OnBeat
+{
+	//Lock free latest value hand over from one writer thread to one reader thread
+	//The writer always has a free slot and the reader always sees a whole value, neither waits
+	template<typename T>
+	class TripleBuffer
+	{
+		public:
+			//Slot owned by the writer until Publish
+			T& Write() { return Buffers[Back]; }
+
+			void Publish()
+			{
+				Back = Ready.exchange(Back | Dirty, std::memory_order_acq_rel) & Index;
+			}
+
+			//Newest published value, stays valid until the next Read
+			const T& Read()
+			{
+				if (Ready.load(std::memory_order_relaxed) & Dirty)
+				{
+					Front = Ready.exchange(Front, std::memory_order_acq_rel) & Index;
+				}
+				return Buffers[Front];
+			}
+
+		private:
+			static constexpr uint8_t Index = 3;
+			static constexpr uint8_t Dirty = 4;
+
+			std::array<T, 3> Buffers;
+			uint8_t Back = 0;
+			std::atomic<uint8_t> Ready = 1;
+			uint8_t Front = 2;
+	};
+}
@@ -0,0 +1,801 @@
+#include <OnBeat/Util/SongLibrary/SongLibrary.h>
+#include <OnBeat/Util/FNV/FNV.h>
+#include <Hazel/Core/Log.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace OnBeat
+{
+	static const uint32_t Magic = 0x4C53424F; //"OBSL"
+	//Largest tag frame or chunk read, and how far into an mp3 the first frame header is looked for
+	static const size_t HeaderSpan = 1 << 16;
+
+	static uint16_t ReadLE16(const unsigned char* data) { return (uint16_t)(data[0] | data[1] << 8); }
+	static uint32_t ReadLE32(const unsigned char* data) { return data[0] | data[1] << 8 | data[2] << 16 | (uint32_t)data[3] << 24; }
+	static uint32_t ReadBE32(const unsigned char* data) { return (uint32_t)data[0] << 24 | data[1] << 16 | data[2] << 8 | data[3]; }
+	//ID3 sizes keep the top bit of each byte clear
+	static uint32_t ReadSyncsafe(const unsigned char* data)
+	{
+		return (data[0] & 0x7F) << 21 | (data[1] & 0x7F) << 14 | (data[2] & 0x7F) << 7 | (data[3] & 0x7F);
+	}
+
+	static void AppendUtf8(std::string& text, uint32_t code)
+	{
+		if (code < 0x80)
+		{
+			text += (char)code;
+		}
+		else if (code < 0x800)
+		{
+			text += (char)(0xC0 | code >> 6);
+			text += (char)(0x80 | (code & 0x3F));
+		}
+		else if (code < 0x10000)
+		{
+			text += (char)(0xE0 | code >> 12);
+			text += (char)(0x80 | (code >> 6 & 0x3F));
+			text += (char)(0x80 | (code & 0x3F));
+		}
+		else
+		{
+			text += (char)(0xF0 | code >> 18);
+			text += (char)(0x80 | (code >> 12 & 0x3F));
+			text += (char)(0x80 | (code >> 6 & 0x3F));
+			text += (char)(0x80 | (code & 0x3F));
+		}
+	}
+
+	static std::string Trim(std::string text)
+	{
+		size_t end = text.find('\0');
+		if (end != std::string::npos)
+			text.resize(end);
+		while (!text.empty() && std::isspace((unsigned char)text.back()))
+			text.pop_back();
+		size_t start = 0;
+		while (start < text.size() && std::isspace((unsigned char)text[start]))
+			start++;
+		return text.substr(start);
+	}
+
+	static std::string DecodeLatin1(const unsigned char* data, size_t size)
+	{
+		std::string text;
+		for (size_t i = 0; i < size && data[i]; i++)
+		{
+			AppendUtf8(text, data[i]);
+		}
+		return Trim(text);
+	}
+
+	//ID3v2 text frame, the first byte picks Latin-1, UTF-16 with a BOM, UTF-16BE or UTF-8
+	static std::string DecodeText(const unsigned char* data, size_t size)
+	{
+		if (!size)
+			return {};
+
+		uint8_t encoding = data[0];
+		data++;
+		size--;
+		if (encoding == 0)
+			return DecodeLatin1(data, size);
+		if (encoding == 3)
+			return Trim(std::string((const char*)data, size));
+
+		bool big = encoding == 2;
+		size_t i = 0;
+		if (encoding == 1 && size >= 2)
+		{
+			if (data[0] == 0xFF && data[1] == 0xFE)
+				i = 2;
+			else if (data[0] == 0xFE && data[1] == 0xFF)
+			{
+				big = true;
+				i = 2;
+			}
+		}
+
+		auto unit = [&](size_t at) { return big ? (uint32_t)(data[at] << 8 | data[at + 1]) : (uint32_t)(data[at + 1] << 8 | data[at]); };
+		std::string text;
+		for (; i + 1 < size; i += 2)
+		{
+			uint32_t code = unit(i);
+			if (!code)
+				break;
+			//Surrogate pair for anything outside the basic plane
+			if (code >= 0xD800 && code < 0xDC00 && i + 3 < size)
+			{
+				uint32_t low = unit(i + 2);
+				if (low >= 0xDC00 && low < 0xE000)
+				{
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					i += 2;
+				}
+			}
+			AppendUtf8(text, code);
+		}
+		return Trim(text);
+	}
+
+	//Fills the tags from an ID3v2 tag at the start of the file, returns the bytes it takes
+	static uint64_t ReadId3v2(std::ifstream& input, SongEntry& entry)
+	{
+		unsigned char header[10];
+		input.seekg(0);
+		if (!input.read((char*)header, sizeof(header)) || std::memcmp(header, "ID3", 3) != 0)
+		{
+			input.clear();
+			return 0;
+		}
+
+		uint8_t major = header[3];
+		uint8_t flags = header[5];
+		uint64_t end = 10 + (uint64_t)ReadSyncsafe(header + 6);
+		uint64_t total = end + ((flags & 0x10) ? 10 : 0);
+		if (major < 2 || major > 4)
+			return total;
+
+		uint64_t position = 10;
+		if (major >= 3 && (flags & 0x40))
+		{
+			unsigned char extended[4];
+			if (!input.read((char*)extended, sizeof(extended)))
+				return total;
+			position += major == 3 ? 4 + ReadBE32(extended) : ReadSyncsafe(extended);
+		}
+
+		//2.2 uses three character ids and three byte sizes
+		size_t headerSize = major == 2 ? 6 : 10;
+		std::vector<unsigned char> frame;
+		while (position + headerSize <= end)
+		{
+			unsigned char frameHeader[10];
+			input.seekg(position);
+			if (!input.read((char*)frameHeader, headerSize) || !frameHeader[0])
+				break;
+
+			uint32_t size;
+			std::string id;
+			if (major == 2)
+			{
+				size = frameHeader[3] << 16 | frameHeader[4] << 8 | frameHeader[5];
+				id.assign((const char*)frameHeader, 3);
+			}
+			else
+			{
+				size = major == 4 ? ReadSyncsafe(frameHeader + 4) : ReadBE32(frameHeader + 4);
+				id.assign((const char*)frameHeader, 4);
+			}
+
+			std::string* field = nullptr;
+			if (id == "TIT2" || id == "TT2")
+				field = &entry.Title;
+			else if (id == "TPE1" || id == "TP1")
+				field = &entry.Artist;
+			else if (id == "TALB" || id == "TAL")
+				field = &entry.Album;
+
+			//Skips cover art and everything else without reading it
+			if (field && size < HeaderSpan)
+			{
+				frame.resize(size);
+				if (!input.read((char*)frame.data(), size))
+					break;
+				*field = DecodeText(frame.data(), size);
+			}
+			position += headerSize + size;
+		}
+		input.clear();
+		return total;
+	}
+
+	static void ReadId3v1(std::ifstream& input, uint64_t fileSize, SongEntry& entry)
+	{
+		unsigned char tag[128];
+		if (fileSize < sizeof(tag))
+			return;
+		input.seekg(fileSize - sizeof(tag));
+		if (!input.read((char*)tag, sizeof(tag)) || std::memcmp(tag, "TAG", 3) != 0)
+		{
+			input.clear();
+			return;
+		}
+
+		if (entry.Title.empty())
+			entry.Title = DecodeLatin1(tag + 3, 30);
+		if (entry.Artist.empty())
+			entry.Artist = DecodeLatin1(tag + 33, 30);
+		if (entry.Album.empty())
+			entry.Album = DecodeLatin1(tag + 63, 30);
+	}
+
+	static bool ReadMp3(std::ifstream& input, uint64_t fileSize, SongEntry& entry)
+	{
+		static const uint16_t Bitrates[2][15] = {
+			{ 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 },
+			{ 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } };
+		static const uint32_t SampleRates[3] = { 44100, 48000, 32000 };
+
+		uint64_t start = ReadId3v2(input, entry);
+		ReadId3v1(input, fileSize, entry);
+
+		std::vector<unsigned char> buffer(HeaderSpan);
+		input.seekg(start);
+		input.read((char*)buffer.data(), buffer.size());
+		size_t read = (size_t)input.gcount();
+		input.clear();
+
+		//First layer III frame header whose follow on frame also looks valid
+		for (size_t i = 0; i + 4 <= read; i++)
+		{
+			const unsigned char* frame = buffer.data() + i;
+			if (frame[0] != 0xFF || (frame[1] & 0xE0) != 0xE0)
+				continue;
+
+			int version = frame[1] >> 3 & 3;
+			int layer = frame[1] >> 1 & 3;
+			int bitrateIndex = frame[2] >> 4;
+			int rateIndex = frame[2] >> 2 & 3;
+			if (version == 1 || layer != 1 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3)
+				continue;
+
+			bool mpeg1 = version == 3;
+			uint32_t bitrate = Bitrates[mpeg1 ? 0 : 1][bitrateIndex] * 1000;
+			uint32_t sampleRate = SampleRates[rateIndex] >> (mpeg1 ? 0 : version == 2 ? 1 : 2);
+			uint32_t samplesPerFrame = mpeg1 ? 1152 : 576;
+			size_t length = samplesPerFrame / 8 * bitrate / sampleRate + (frame[2] >> 1 & 1);
+			if (i + length + 2 <= read && (buffer[i + length] != 0xFF || (buffer[i + length + 1] & 0xE0) != 0xE0))
+				continue;
+
+			bool mono = (frame[3] >> 6) == 3;
+			entry.SampleRate = sampleRate;
+			entry.Channels = mono ? 1 : 2;
+
+			//VBR files carry the real frame count in a Xing or VBRI header inside the first frame
+			uint64_t frames = 0;
+			size_t xing = i + 4 + (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17));
+			size_t vbri = i + 4 + 32;
+			if (xing + 12 <= read && (!std::memcmp(&buffer[xing], "Xing", 4) || !std::memcmp(&buffer[xing], "Info", 4)) &&
+				(ReadBE32(&buffer[xing + 4]) & 1))
+			{
+				frames = ReadBE32(&buffer[xing + 8]);
+			}
+			else if (vbri + 18 <= read && !std::memcmp(&buffer[vbri], "VBRI", 4))
+			{
+				frames = ReadBE32(&buffer[vbri + 14]);
+			}
+
+			if (frames)
+			{
+				entry.Duration = (double)frames * samplesPerFrame / sampleRate;
+			}
+			else
+			{
+				uint64_t audio = fileSize - std::min(fileSize, start + i);
+				entry.Duration = audio * 8.0 / bitrate;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	static bool ReadWav(std::ifstream& input, uint64_t fileSize, SongEntry& entry)
+	{
+		unsigned char header[12];
+		input.seekg(0);
+		if (!input.read((char*)header, sizeof(header)) || std::memcmp(header, "RIFF", 4) != 0 ||
+			std::memcmp(header + 8, "WAVE", 4) != 0)
+		{
+			return false;
+		}
+
+		uint32_t byteRate = 0;
+		uint64_t dataSize = 0;
+		bool format = false;
+		uint64_t position = sizeof(header);
+		std::vector<unsigned char> chunk;
+		while (position + 8 <= fileSize)
+		{
+			unsigned char chunkHeader[8];
+			input.seekg(position);
+			if (!input.read((char*)chunkHeader, sizeof(chunkHeader)))
+				break;
+			uint32_t size = ReadLE32(chunkHeader + 4);
+
+			if (!std::memcmp(chunkHeader, "fmt ", 4) && size >= 16)
+			{
+				unsigned char fmt[16];
+				if (!input.read((char*)fmt, sizeof(fmt)))
+					break;
+				entry.Channels = ReadLE16(fmt + 2);
+				entry.SampleRate = ReadLE32(fmt + 4);
+				byteRate = ReadLE32(fmt + 8);
+				format = true;
+			}
+			else if (!std::memcmp(chunkHeader, "data", 4))
+			{
+				//Streamed files leave the size unset
+				dataSize = std::min<uint64_t>(size, fileSize - position - 8);
+			}
+			else if (!std::memcmp(chunkHeader, "LIST", 4) && size >= 4 && size < HeaderSpan)
+			{
+				chunk.resize(size);
+				if (!input.read((char*)chunk.data(), size))
+					break;
+				if (!std::memcmp(chunk.data(), "INFO", 4))
+				{
+					for (size_t i = 4; i + 8 <= size;)
+					{
+						uint32_t length = std::min<uint32_t>(ReadLE32(&chunk[i + 4]), (uint32_t)(size - i - 8));
+						std::string text = Trim(std::string((const char*)&chunk[i + 8], length));
+						if (!std::memcmp(&chunk[i], "INAM", 4))
+							entry.Title = text;
+						else if (!std::memcmp(&chunk[i], "IART", 4))
+							entry.Artist = text;
+						else if (!std::memcmp(&chunk[i], "IPRD", 4))
+							entry.Album = text;
+						i += 8 + length + (length & 1);
+					}
+				}
+			}
+			//Chunks are padded to an even size
+			position += 8 + (uint64_t)size + (size & 1);
+		}
+		input.clear();
+
+		if (byteRate)
+			entry.Duration = (double)dataSize / byteRate;
+		return format;
+	}
+
+	bool SongLibrary::ReadMetadata(const std::string& path, SongEntry& entry)
+	{
+		std::ifstream input(path, std::ios::binary);
+		if (!input)
+			return false;
+
+		input.seekg(0, std::ios::end);
+		uint64_t fileSize = (uint64_t)input.tellg();
+		input.seekg(0);
+
+		std::string extension = std::filesystem::path(path).extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(),
+			[](unsigned char c) { return (char)std::tolower(c); });
+		bool read = extension == ".wav" ? ReadWav(input, fileSize, entry) : ReadMp3(input, fileSize, entry);
+		//A failed header read leaves the stream failed, the hash below still has to see the file
+		input.clear();
+
+		if (entry.Title.empty())
+			entry.Title = std::filesystem::path(path).stem().string();
+
+		entry.Hash = FNV::File(input, fileSize);
+		return read;
+	}
+
+	SongLibrary& SongLibrary::Get()
+	{
+		static SongLibrary library;
+		return library;
+	}
+
+	void SongLibrary::Configure(const std::vector<std::string>& folders)
+	{
+		if (Running && folders == Folders)
+			return;
+
+		Stop();
+		Folders = folders;
+		//The index is what makes startup instant, the scan only corrects it
+		if (!Loaded)
+		{
+			Loaded = true;
+			if (LoadIndex())
+				HZ_INFO("Song library: {0} songs from the index", Songs->size());
+		}
+		if (Folders.empty())
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			Songs = std::make_shared<const std::vector<SongEntry>>();
+			Version.fetch_add(1, std::memory_order_release);
+			return;
+		}
+
+		Running = true;
+		ScanRequested = true;
+		Worker = std::thread(&SongLibrary::Work, this);
+	}
+
+	void SongLibrary::Refresh()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			if (!Running || Watching)
+				return;
+			ScanRequested = true;
+		}
+		Wake.notify_all();
+	}
+
+	void SongLibrary::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			Running = false;
+		}
+		Wake.notify_all();
+		if (Worker.joinable())
+			Worker.join();
+		NotifyScanned();
+
+		Unwatch();
+#ifdef __linux__
+		if (Watcher >= 0)
+		{
+			close(Watcher);
+			Watcher = -1;
+		}
+#endif
+		ScanRequested = false;
+		Scanning = false;
+	}
+
+	SongList SongLibrary::GetSongs() const
+	{
+		std::lock_guard<std::mutex> lock(Lock);
+		return Songs;
+	}
+
+	bool SongLibrary::GetScanning() const
+	{
+		std::lock_guard<std::mutex> lock(Lock);
+		return Running && (ScanRequested || Scanning);
+	}
+
+	void SongLibrary::SetScanCallback(std::function<void()> callback)
+	{
+		std::lock_guard<std::mutex> lock(Lock);
+		ScanCallback = std::move(callback);
+	}
+
+	void SongLibrary::NotifyScanned()
+	{
+		//Copied so the callback runs without Lock, it may call back into the library
+		std::function<void()> callback;
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			callback = ScanCallback;
+		}
+		if (callback)
+			callback();
+	}
+
+	void SongLibrary::Work()
+	{
+		while (WaitForChanges())
+		{
+			Scan();
+		}
+	}
+
+	void SongLibrary::Scan()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			ScanRequested = false;
+			Scanning = true;
+		}
+
+		SongList previous = GetSongs();
+		std::unordered_map<std::string, const SongEntry*> known;
+		known.reserve(previous->size());
+		for (auto& song : *previous)
+		{
+			known[song.Path] = &song;
+		}
+
+		std::vector<SongEntry> songs;
+		std::vector<std::string> directories;
+		songs.reserve(previous->size());
+		size_t read = 0;
+		for (auto& folder : Folders)
+		{
+			std::error_code error;
+			std::filesystem::recursive_directory_iterator it(folder,
+				std::filesystem::directory_options::skip_permission_denied, error), end;
+			if (error)
+			{
+				HZ_WARN("Music folder {0} could not be read", folder);
+				continue;
+			}
+			directories.push_back(folder);
+
+			for (; it != end && Running; it.increment(error))
+			{
+				if (error)
+					break;
+				if (it->is_directory(error))
+				{
+					directories.push_back(it->path().string());
+					continue;
+				}
+				if (!it->is_regular_file(error))
+					continue;
+
+				std::string extension = it->path().extension().string();
+				std::transform(extension.begin(), extension.end(), extension.begin(),
+					[](unsigned char c) { return (char)std::tolower(c); });
+				if (extension != ".wav" && extension != ".mp3")
+					continue;
+
+				SongEntry entry;
+				entry.Path = it->path().string();
+				entry.Size = it->file_size(error);
+				entry.Modified = it->last_write_time(error).time_since_epoch().count();
+
+				//Unchanged files cost one stat, only new or edited ones are opened
+				auto found = known.find(entry.Path);
+				if (found != known.end() && found->second->Size == entry.Size && found->second->Modified == entry.Modified)
+				{
+					songs.push_back(*found->second);
+					continue;
+				}
+				if (!ReadMetadata(entry.Path, entry))
+					HZ_WARN("Could not read the format of {0}", entry.Path);
+				songs.push_back(std::move(entry));
+				read++;
+			}
+		}
+
+		if (Running)
+		{
+			std::sort(songs.begin(), songs.end(), [](const SongEntry& a, const SongEntry& b) { return a.Path < b.Path; });
+			songs.erase(std::unique(songs.begin(), songs.end(),
+				[](const SongEntry& a, const SongEntry& b) { return a.Path == b.Path; }), songs.end());
+
+			//Every kept song came from the old list, so an equal count means nothing was removed either
+			if (read || songs.size() != previous->size())
+			{
+				HZ_INFO("Song library: {0} songs, {1} read", songs.size(), read);
+				SaveIndex(songs);
+				{
+					std::lock_guard<std::mutex> lock(Lock);
+					Songs = std::make_shared<const std::vector<SongEntry>>(std::move(songs));
+				}
+				Version.fetch_add(1, std::memory_order_release);
+			}
+			Watch(directories);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(Lock);
+			Scanning = false;
+		}
+		NotifyScanned();
+	}
+
+	bool SongLibrary::WaitForChanges()
+	{
+#ifdef __linux__
+		if (Watcher >= 0)
+		{
+			pollfd descriptor = { Watcher, POLLIN, 0 };
+			auto settle = std::chrono::steady_clock::time_point::max();
+			while (true)
+			{
+				{
+					std::lock_guard<std::mutex> lock(Lock);
+					if (!Running)
+						return false;
+					if (ScanRequested)
+						return true;
+				}
+
+				//Short timeout so stopping never waits long
+				if (poll(&descriptor, 1, 100) > 0)
+				{
+					char events[4096];
+					while (read(Watcher, events, sizeof(events)) > 0);
+					settle = std::chrono::steady_clock::now() + std::chrono::milliseconds(OB_SONG_LIBRARY_SETTLE);
+				}
+				if (std::chrono::steady_clock::now() >= settle)
+					return true;
+			}
+		}
+#endif
+		std::unique_lock<std::mutex> lock(Lock);
+		Wake.wait(lock, [this]() { return ScanRequested || !Running; });
+		return Running;
+	}
+
+	void SongLibrary::Watch(const std::vector<std::string>& directories)
+	{
+#ifdef __linux__
+		Unwatch();
+		if (Watcher < 0)
+			Watcher = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (Watcher < 0)
+			return;
+
+		for (auto& directory : directories)
+		{
+			int watch = inotify_add_watch(Watcher, directory.c_str(),
+				IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF);
+			if (watch < 0)
+			{
+				//Usually the per user watch limit, rescanning on the menu still works
+				HZ_WARN("Could not watch {0}, falling back to rescans", directory);
+				Unwatch();
+				close(Watcher);
+				Watcher = -1;
+				return;
+			}
+			Watches.push_back(watch);
+		}
+		Watching = true;
+#endif
+	}
+
+	void SongLibrary::Unwatch()
+	{
+#ifdef __linux__
+		for (int watch : Watches)
+		{
+			inotify_rm_watch(Watcher, watch);
+		}
+#endif
+		Watches.clear();
+		Watching = false;
+	}
+
+	static void WriteString(std::ofstream& output, const std::string& text)
+	{
+		uint32_t size = (uint32_t)text.size();
+		output.write((const char*)&size, sizeof(size));
+		output.write(text.data(), size);
+	}
+
+	//Reads from the whole index held in memory, one read call for the file is what keeps loading fast
+	struct IndexReader
+	{
+		const std::vector<char>& Data;
+		size_t Offset = 0;
+		bool Failed = false;
+
+		template<typename T>
+		T Read()
+		{
+			T value = {};
+			if (Offset + sizeof(T) > Data.size())
+			{
+				Failed = true;
+				return value;
+			}
+			std::memcpy(&value, Data.data() + Offset, sizeof(T));
+			Offset += sizeof(T);
+			return value;
+		}
+
+		std::string ReadString()
+		{
+			uint32_t size = Read<uint32_t>();
+			if (Failed || Offset + size > Data.size())
+			{
+				Failed = true;
+				return {};
+			}
+			std::string text(Data.data() + Offset, size);
+			Offset += size;
+			return text;
+		}
+	};
+
+	bool SongLibrary::LoadIndex()
+	{
+		std::ifstream input(OB_SONG_LIBRARY_INDEX, std::ios::binary | std::ios::ate);
+		if (!input)
+			return false;
+
+		std::vector<char> data((size_t)input.tellg());
+		input.seekg(0);
+		if (!input.read(data.data(), data.size()))
+			return false;
+
+		IndexReader reader{ data };
+		if (reader.Read<uint32_t>() != Magic || reader.Read<uint32_t>() != OB_SONG_LIBRARY_VERSION)
+			return false;
+
+		//Songs from other folders would show until the first scan removed them
+		std::vector<std::string> folders(reader.Read<uint32_t>());
+		for (auto& folder : folders)
+		{
+			folder = reader.ReadString();
+		}
+		if (reader.Failed || folders != Folders)
+			return false;
+
+		uint32_t count = reader.Read<uint32_t>();
+		auto songs = std::make_shared<std::vector<SongEntry>>();
+		songs->reserve(std::min<size_t>(count, data.size() / 32));
+		for (uint32_t i = 0; i < count && !reader.Failed; i++)
+		{
+			SongEntry song;
+			song.Path = reader.ReadString();
+			song.Title = reader.ReadString();
+			song.Artist = reader.ReadString();
+			song.Album = reader.ReadString();
+			song.Size = reader.Read<uint64_t>();
+			song.Modified = reader.Read<int64_t>();
+			song.Hash = reader.Read<uint64_t>();
+			song.Duration = reader.Read<double>();
+			song.SampleRate = reader.Read<uint32_t>();
+			song.Channels = reader.Read<uint16_t>();
+			songs->push_back(std::move(song));
+		}
+		if (reader.Failed)
+			return false;
+
+		std::lock_guard<std::mutex> lock(Lock);
+		Songs = songs;
+		Version.fetch_add(1, std::memory_order_release);
+		return true;
+	}
+
+	void SongLibrary::SaveIndex(const std::vector<SongEntry>& songs)
+	{
+		std::string temporary = std::string(OB_SONG_LIBRARY_INDEX) + ".tmp";
+		{
+			std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+			if (!output)
+				return;
+
+			uint32_t version = OB_SONG_LIBRARY_VERSION;
+			uint32_t folders = (uint32_t)Folders.size();
+			uint32_t count = (uint32_t)songs.size();
+			output.write((const char*)&Magic, sizeof(Magic));
+			output.write((const char*)&version, sizeof(version));
+			output.write((const char*)&folders, sizeof(folders));
+			for (auto& folder : Folders)
+			{
+				WriteString(output, folder);
+			}
+
+			output.write((const char*)&count, sizeof(count));
+			for (auto& song : songs)
+			{
+				WriteString(output, song.Path);
+				WriteString(output, song.Title);
+				WriteString(output, song.Artist);
+				WriteString(output, song.Album);
+				output.write((const char*)&song.Size, sizeof(song.Size));
+				output.write((const char*)&song.Modified, sizeof(song.Modified));
+				output.write((const char*)&song.Hash, sizeof(song.Hash));
+				output.write((const char*)&song.Duration, sizeof(song.Duration));
+				output.write((const char*)&song.SampleRate, sizeof(song.SampleRate));
+				output.write((const char*)&song.Channels, sizeof(song.Channels));
+			}
+			if (!output)
+				return;
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporary, OB_SONG_LIBRARY_INDEX, error);
+		if (error)
+			std::filesystem::remove(temporary, error);
+	}
+
+	SongLibrary::~SongLibrary()
+	{
+		Stop();
+	}
+}
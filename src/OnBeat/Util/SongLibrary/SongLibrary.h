@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define OB_SONG_LIBRARY_INDEX "assets/user/library.index"
+//Bumped whenever SongEntry or the file layout changes, an old index is rebuilt from scratch
+#define OB_SONG_LIBRARY_VERSION 1
+//Quiet time after a filesystem change before rescanning, so a copied album is one rescan
+#define OB_SONG_LIBRARY_SETTLE 500
+
+namespace OnBeat
+{
+	struct SongEntry
+	{
+		std::string Path;
+		//Falls back to the file name when the song has no tags
+		std::string Title;
+		std::string Artist;
+		std::string Album;
+		uint64_t Size = 0;
+		//Raw file clock ticks, only ever compared with itself
+		int64_t Modified = 0;
+		//FNV::File, spots the same song under another name and keys its analysis cache entry
+		uint64_t Hash = 0;
+		double Duration = 0.0;
+		uint32_t SampleRate = 0;
+		uint16_t Channels = 0;
+	};
+
+	typedef std::shared_ptr<const std::vector<SongEntry>> SongList;
+
+	//Every song under the music folders, kept in a binary index so startup never waits on a scan
+	//Rescans only read files whose size or modification time changed, on Linux inotify triggers them
+	class SongLibrary
+	{
+		public:
+			static SongLibrary& Get();
+
+			//Loads the index the first time and rescans in the background when the folders change
+			void Configure(const std::vector<std::string>& folders);
+			//Rescans unless a watcher already keeps the index current
+			void Refresh();
+			void Stop();
+
+			//Snapshot sorted by path, never changes once returned
+			SongList GetSongs() const;
+			//Increases every time the songs change
+			uint64_t GetVersion() const { return Version.load(std::memory_order_acquire); }
+			//True until the index matches the folders
+			bool GetScanning() const;
+			//Called on the scanning thread after every scan and on the stopping thread when the library stops
+			void SetScanCallback(std::function<void()> callback);
+
+			//Reads tags, duration and format from the file headers without decoding any audio
+			static bool ReadMetadata(const std::string& path, SongEntry& entry);
+
+		private:
+			SongLibrary() = default;
+			~SongLibrary();
+
+			void Work();
+			void Scan();
+			void NotifyScanned();
+			//Sleeps until a rescan is wanted, false once stopping
+			bool WaitForChanges();
+			void Watch(const std::vector<std::string>& directories);
+			void Unwatch();
+
+			bool LoadIndex();
+			void SaveIndex(const std::vector<SongEntry>& songs);
+
+			std::thread Worker;
+			mutable std::mutex Lock;
+			std::condition_variable Wake;
+			std::atomic<bool> Running = false;
+			bool ScanRequested = false;
+			bool Scanning = false;
+			std::function<void()> ScanCallback;
+
+			std::vector<std::string> Folders;
+			SongList Songs = std::make_shared<const std::vector<SongEntry>>();
+			std::atomic<uint64_t> Version = 0;
+
+			//inotify descriptor, -1 without a watcher, only touched by the worker
+			int Watcher = -1;
+			std::vector<int> Watches;
+			std::atomic<bool> Watching = false;
+			bool Loaded = false;
+	};
+}
@@ -0,0 +1,75 @@
+#include <OnBeat/Util/SongLibrary/SongView/SongView.h>
+#include <algorithm>
+#include <cctype>
+
+namespace OnBeat
+{
+	//ASCII only, anything else is compared as written
+	static std::string Lower(const std::string& text)
+	{
+		std::string lower = text;
+		std::transform(lower.begin(), lower.end(), lower.begin(),
+			[](unsigned char c) { return (char)std::tolower(c); });
+		return lower;
+	}
+
+	void SongView::Update(SongSort sort, bool descending, const std::string& filter)
+	{
+		SongLibrary& library = SongLibrary::Get();
+		uint64_t version = library.GetVersion();
+		std::string lower = Lower(filter);
+		if (Built && version == Version && sort == Sort && descending == Descending && lower == Filter)
+			return;
+
+		if (!Built || version != Version)
+		{
+			//Version first, a change between the two calls is caught by the next Update
+			Version = version;
+			Songs = library.GetSongs();
+			Keys.clear();
+			Keys.reserve(Songs->size());
+			for (auto& song : *Songs)
+			{
+				Keys.push_back({ Lower(song.Title), Lower(song.Artist), Lower(song.Album) });
+			}
+		}
+
+		Sort = sort;
+		Descending = descending;
+		Filter = lower;
+		Built = true;
+		Rebuild();
+	}
+
+	void SongView::Rebuild()
+	{
+		Order.clear();
+		Order.reserve(Songs->size());
+		for (uint32_t i = 0; i < (uint32_t)Songs->size(); i++)
+		{
+			const Key& key = Keys[i];
+			if (Filter.empty() || key.Title.find(Filter) != std::string::npos ||
+				key.Artist.find(Filter) != std::string::npos || key.Album.find(Filter) != std::string::npos)
+			{
+				Order.push_back(i);
+			}
+		}
+
+		//Snapshots are sorted by path, a stable sort keeps that as the tie break
+		auto compare = [this](uint32_t a, uint32_t b)
+		{
+			switch (Sort)
+			{
+				case SongSort::Title: return Keys[a].Title < Keys[b].Title;
+				case SongSort::Artist: return Keys[a].Artist < Keys[b].Artist;
+				case SongSort::Album: return Keys[a].Album < Keys[b].Album;
+				case SongSort::Duration: return (*Songs)[a].Duration < (*Songs)[b].Duration;
+				default: return false;
+			}
+		};
+		if (Sort != SongSort::Path)
+			std::stable_sort(Order.begin(), Order.end(), compare);
+		if (Descending)
+			std::reverse(Order.begin(), Order.end());
+	}
+}
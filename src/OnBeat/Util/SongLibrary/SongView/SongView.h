@@ -0,0 +1,53 @@
+#pragma once
+#include <OnBeat/Util/SongLibrary/SongLibrary.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OnBeat
+{
+	enum class SongSort : uint8_t
+	{
+		Title,
+		Artist,
+		Album,
+		Duration,
+		Path
+	};
+
+	//Sorted and filtered order over a library snapshot, so menus only ever copy out the rows they show
+	//The order is rebuilt only when the library, sort or filter changes, paging through it is free
+	class SongView
+	{
+		public:
+			//Filter matches case insensitively anywhere in the title, artist or album
+			void Update(SongSort sort, bool descending, const std::string& filter);
+
+			size_t GetCount() const { return Order.size(); }
+			//Index into the current order, valid until the next Update
+			const SongEntry& GetSong(size_t index) const { return (*Songs)[Order[index]]; }
+			//Library version the order was built from
+			uint64_t GetVersion() const { return Version; }
+
+		private:
+			//Lower case copies made once per snapshot so sorting and filtering never allocate
+			struct Key
+			{
+				std::string Title;
+				std::string Artist;
+				std::string Album;
+			};
+
+			void Rebuild();
+
+			SongList Songs = std::make_shared<const std::vector<SongEntry>>();
+			std::vector<Key> Keys;
+			std::vector<uint32_t> Order;
+			uint64_t Version = 0;
+			bool Built = false;
+
+			SongSort Sort = SongSort::Title;
+			bool Descending = false;
+			std::string Filter;
+	};
+}
@@ -1,19 +1,42 @@
 #pragma once
 #include "AudioPlayer/AudioPlayer.h"
+#include "AudioPlayer/AudioClock/AudioClock.h"
+#include "AudioPlayer/Hitsounds/Hitsounds.h"
 
 #include "AppUtil/AppUtil.h"
 
 #include "Discord/Integration.h"
 
+#include "FNV/FNV.h"
+
+#include "FramePacer/FramePacer.h"
+
+#include "Input/Input.h"
+
+#include "Jobs/Jobs.h"
+
 #include "JS/JS.h"
 
+#include "LibraryScheduler/LibraryScheduler.h"
+
 #include "Loader/Loader.h"
 #include "Loader/LoadingLayer/LoadingLayer.h"
 
 #include "OnSetDetection/OnSetDetection.h"
+#include "OnSetDetection/AnalysisCache/AnalysisCache.h"
+#include "OnSetDetection/FFT/FFT.h"
+#include "OnSetDetection/Spectrogram/Spectrogram.h"
+
+#include "Queue/MPSCQueue.h"
+#include "Queue/SeqLock.h"
+#include "Queue/SPSCQueue.h"
+#include "Queue/TripleBuffer.h"
 
 #include "Secrets/Secrets.h"
 
+#include "SongLibrary/SongLibrary.h"
+#include "SongLibrary/SongView/SongView.h"
+
 #include "Template/GLTextureSurface.h"
 #include "Template/Layer.h"
 #include "Template/Menu.h"
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <OnBeat/Util/AudioPlayer/AudioClock/AudioClock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace OnBeat;
+
+namespace
+{
+	struct DriftResult
+	{
+		//Worst error of a single frame, and of the error averaged over 10 second windows
+		double MaxError = 0.0;
+		double MaxWindowError = 0.0;
+		double MaxDrift = 0.0;
+		uint64_t Snaps = 0;
+	};
+
+	//Plays a song through the clock the way Simulation does, the mixer publishes its position once per block
+	//The audio device runs off its own crystal so song time is skewed from the frame clock by ppm
+	DriftResult PlaySong(double seconds, double frameRate, double ppm, unsigned int block = 1024, int rate = 48000)
+	{
+		AudioClock clock;
+		clock.Reset();
+		clock.Update(0.0, 0.0, false);
+
+		std::mt19937 random(34);
+		std::uniform_real_distribution<double> jitter(-0.0005, 0.0005);
+
+		DriftResult result;
+		double now = 0.0, windowError = 0.0;
+		int windowFrames = 0;
+		while (now < seconds)
+		{
+			//Scheduler jitter on every frame and a 30ms hitch every so often
+			double delta = 1.0 / frameRate + jitter(random);
+			if (random() % 5000 == 0)
+			{
+				delta += 0.03;
+			}
+			now += delta;
+
+			double song = now * (1.0 + ppm / 1e6);
+			double reading = std::floor(song * rate / block) * block / rate;
+			double error = clock.Update(reading, delta, true) - song;
+
+			//The first second is the clock locking on
+			if (now < 1.0)
+				continue;
+			result.MaxError = std::max(result.MaxError, std::abs(error));
+			windowError += error;
+			if (++windowFrames == (int)(frameRate * 10))
+			{
+				result.MaxWindowError = std::max(result.MaxWindowError, std::abs(windowError / windowFrames));
+				windowError = 0.0;
+				windowFrames = 0;
+			}
+		}
+		result.MaxDrift = clock.GetStats().MaxDrift;
+		result.Snaps = clock.GetStats().Snaps;
+		return result;
+	}
+}
+
+TEST(AudioClock, DriftStaysUnderOneMillisecondOverTenMinutes)
+{
+	for (double frameRate : { 60.0, 144.0 })
+	{
+		for (double ppm : { -100.0, 0.0, 100.0 })
+		{
+			SCOPED_TRACE(testing::Message() << frameRate << "fps " << ppm << "ppm");
+			DriftResult result = PlaySong(600.0, frameRate, ppm);
+
+			EXPECT_LT(result.MaxWindowError, 0.001);
+			EXPECT_LT(result.MaxDrift, 0.001);
+			//A single frame can be off by its jitter and a hitch, never by a whole block
+			EXPECT_LT(result.MaxError, 0.005);
+			EXPECT_EQ(result.Snaps, 0u);
+		}
+	}
+}
+
+TEST(AudioClock, SnapsToASeek)
+{
+	AudioClock clock;
+	clock.Reset();
+	clock.Update(0.0, 0.0, false);
+	for (int frame = 1; frame <= 60; frame++)
+	{
+		clock.Update(std::floor(frame / 60.0 * 48000 / 1024) * 1024 / 48000, 1 / 60.0, true);
+	}
+
+	//Jumping well past the snap threshold moves straight to the audio
+	EXPECT_DOUBLE_EQ(clock.Update(30.0, 1 / 60.0, true), 30.0);
+	EXPECT_EQ(clock.GetStats().Snaps, 1u);
+}
+
+TEST(AudioClock, HoldsWhilePaused)
+{
+	AudioClock clock;
+	clock.Reset();
+	EXPECT_DOUBLE_EQ(clock.Update(12.5, 1 / 60.0, false), 12.5);
+	EXPECT_DOUBLE_EQ(clock.Update(12.5, 1 / 60.0, false), 12.5);
+}
@@ -0,0 +1,65 @@
+#include <OnBeat/App/MusicLayer/Chart/Chart.h>
+#include <OnBeat/App/MusicLayer/NoteRenderer/NoteMesh/NoteMesh.h>
+#include <gtest/gtest.h>
+
+using namespace OnBeat;
+
+TEST(Chart, FinaliseSortsAndRemovesDuplicates)
+{
+	Chart chart(2);
+	chart.Add(0, 300);
+	chart.Add(0, 100);
+	chart.Add(0, 300);
+	chart.Add(1, 200);
+	chart.Finalise();
+
+	EXPECT_EQ(chart.GetColumn(0), (std::vector<int64_t>{ 100, 300 }));
+	EXPECT_EQ(chart.GetColumn(1), (std::vector<int64_t>{ 200 }));
+	EXPECT_EQ(chart.GetNoteCount(), 3u);
+
+	chart.Clear();
+	EXPECT_EQ(chart.GetColumnCount(), 2);
+	EXPECT_EQ(chart.GetNoteCount(), 0u);
+}
+
+TEST(NoteMesh, BuildsOneQuadPerNote)
+{
+	Chart chart(2);
+	chart.Add(0, 44100);
+	chart.Add(1, 88200);
+	chart.Finalise();
+
+	NoteMesh mesh;
+	mesh.Build(chart, 44100.0);
+	ASSERT_EQ(mesh.GetNoteCount(), 2u);
+	ASSERT_EQ(mesh.GetVertices().size(), 8u);
+	ASSERT_EQ(mesh.GetIndices().size(), 12u);
+
+	const NoteVertex& first = mesh.GetVertices()[0];
+	EXPECT_FLOAT_EQ(first.Time, 1.0f);
+	EXPECT_FLOAT_EQ(first.Lane, 0.0f);
+	EXPECT_FLOAT_EQ(mesh.GetVertices()[4].Time, 2.0f);
+	EXPECT_FLOAT_EQ(mesh.GetVertices()[4].Lane, 1.0f);
+
+	//Two triangles sharing the quad's diagonal, offset per note
+	std::vector<uint32_t> second(mesh.GetIndices().begin() + 6, mesh.GetIndices().end());
+	EXPECT_EQ(second, (std::vector<uint32_t>{ 4, 5, 6, 6, 7, 4 }));
+}
+
+TEST(NoteMesh, DropsColumnsPastTheLaneLimit)
+{
+	Chart chart(OB_MAX_LANES + 2);
+	for (int c = 0; c < chart.GetColumnCount(); c++)
+	{
+		chart.Add(c, 1000);
+	}
+	chart.Finalise();
+
+	NoteMesh mesh;
+	mesh.Build(chart, 1000.0);
+	EXPECT_EQ(mesh.GetNoteCount(), (uint32_t)OB_MAX_LANES);
+	for (auto& vertex : mesh.GetVertices())
+	{
+		EXPECT_LT(vertex.Lane, (float)OB_MAX_LANES);
+	}
+}
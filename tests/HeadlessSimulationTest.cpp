@@ -0,0 +1,204 @@
+#include <OnBeat/App/MusicLayer/Simulation/Simulation.h>
+#include <OnBeat/Util/Input/Input.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace OnBeat;
+
+namespace
+{
+	//Quiet 16 bit mono tone so the song channel keeps playing for the whole run
+	std::string WriteSong(double seconds, int rate = 44100)
+	{
+		std::string file = (std::filesystem::temp_directory_path() / "OnBeatHeadlessSong.wav").string();
+		uint32_t frames = (uint32_t)(seconds * rate);
+		uint32_t bytes = frames * 2;
+		uint32_t riff = 36 + bytes, fmtSize = 16, byteRate = rate * 2, sampleRate = rate;
+		uint16_t format = 1, channels = 1, align = 2, bits = 16;
+
+		std::ofstream output(file, std::ios::binary);
+		output.write("RIFF", 4).write((char*)&riff, 4).write("WAVE", 4);
+		output.write("fmt ", 4).write((char*)&fmtSize, 4).write((char*)&format, 2).write((char*)&channels, 2);
+		output.write((char*)&sampleRate, 4).write((char*)&byteRate, 4).write((char*)&align, 2).write((char*)&bits, 2);
+		output.write("data", 4).write((char*)&bytes, 4);
+		for (uint32_t i = 0; i < frames; i++)
+		{
+			int16_t sample = (int16_t)(3000.0 * std::sin(i * 2.0 * 3.14159265358979 * 440.0 / rate));
+			output.write((char*)&sample, 2);
+		}
+		return file;
+	}
+
+	//Song time after every block of a headless play through
+	std::vector<double> Play(const std::string& song, unsigned int blocks, double& mixed)
+	{
+		AudioPlayer player("", AudioOutput::NoSound);
+		Chart chart(4);
+		chart.Add(0, 44100);
+		chart.Finalise();
+
+		Simulation sim(player);
+		sim.SetChart(&chart, 44100.0);
+		player.LoadAudio(song);
+		EXPECT_TRUE(player.Advance(1));
+		EXPECT_TRUE(player.GetLoaded());
+
+		sim.Start();
+		player.PlayAudio();
+		std::vector<double> times;
+		for (unsigned int i = 0; i < blocks; i++)
+		{
+			EXPECT_TRUE(sim.Advance(1));
+			times.push_back(sim.Read().SongTime);
+		}
+		mixed = player.GetPosition();
+		sim.Stop();
+		return times;
+	}
+}
+
+TEST(HeadlessSimulation, InputClockCountsMixedBlocks)
+{
+	int64_t block, rate;
+	{
+		AudioPlayer player("", AudioOutput::NoSound);
+		ASSERT_TRUE(player.Advance(10));
+		block = player.GetBlockLength();
+		rate = player.GetOutputRate();
+		EXPECT_EQ(Input::Now(), 10 * block * 1000000000LL / rate);
+
+		ASSERT_TRUE(player.Advance(rate / block));
+		EXPECT_EQ(Input::Now(), (10 + rate / block) * block * 1000000000LL / rate);
+	}
+
+	//Back on the steady clock once the headless player is gone
+	EXPECT_GT(Input::Now(), 100 * block * 1000000000LL / rate);
+}
+
+TEST(HeadlessSimulation, SongTimeIsRepeatable)
+{
+	std::string song = WriteSong(10.0);
+	double first = 0.0, second = 0.0;
+	std::vector<double> a = Play(song, 400, first);
+	std::vector<double> b = Play(song, 400, second);
+	std::filesystem::remove(song);
+
+	//Same blocks in, same song time out, whatever the machine was doing meanwhile
+	EXPECT_EQ(a, b);
+	EXPECT_EQ(first, second);
+	ASSERT_GT(first, 1.0);
+	EXPECT_NEAR(a.back(), first, 0.005);
+	EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+}
+
+TEST(HeadlessSimulation, JudgesPressesByTheirTimestamps)
+{
+	std::string song = WriteSong(6.0);
+	{
+		AudioPlayer player("", AudioOutput::NoSound);
+		Chart chart(4);
+		for (int c = 0; c < 4; c++)
+		{
+			chart.Add(c, (c + 1) * 44100);
+		}
+		chart.Finalise();
+
+		//Any key codes will do, presses are matched against the column keys
+		std::vector<int> keys = { 10, 11, 12, 13 };
+		Simulation sim(player);
+		sim.SetChart(&chart, 44100.0);
+		sim.SetInput(keys, HitWindows());
+		player.LoadAudio(song);
+		ASSERT_TRUE(player.Advance(1));
+		ASSERT_TRUE(player.GetLoaded());
+		sim.Start();
+		player.PlayAudio();
+
+		struct Press
+		{
+			int Column;
+			double Time;
+			Hit Type;
+		};
+		//Note c is at c + 1 seconds
+		const Press presses[] = {
+			{ 0, 1.005, Hit::Perfect },
+			{ 1, 1.96, Hit::Good },
+			{ 2, 3.07, Hit::Miss },
+			{ 3, 3.987, Hit::Perfect }
+		};
+		for (const Press& press : presses)
+		{
+			SCOPED_TRACE(testing::Message() << "Column " << press.Column);
+			//Stamped a block or so before the tick that reads it, like a press made while a frame renders
+			while (sim.Read().SongTime < press.Time + 0.02)
+			{
+				ASSERT_TRUE(sim.Advance(1));
+			}
+			SimulationState before = sim.Read();
+			int64_t stamp = before.Time - (int64_t)((before.SongTime - press.Time) * 1e9);
+			Input::Get().Push(keys[press.Column], true, stamp);
+			Input::Get().Push(keys[press.Column], false, stamp + 1000000);
+			ASSERT_TRUE(sim.Advance(1));
+
+			SimulationState after = sim.Read();
+			EXPECT_EQ(after.LastHit.Type, press.Type);
+			EXPECT_EQ(after.LastHit.Column, press.Column);
+			EXPECT_NEAR(after.LastHit.Offset, press.Time - (press.Column + 1), 0.001);
+		}
+
+		const Judgement::Score& score = sim.Read().Score;
+		EXPECT_EQ(score.Counts[(size_t)Hit::Perfect], 2u);
+		EXPECT_EQ(score.Counts[(size_t)Hit::Good], 1u);
+		EXPECT_EQ(score.Counts[(size_t)Hit::Miss], 1u);
+		EXPECT_EQ(score.Combo, 1u);
+		sim.Stop();
+	}
+	std::filesystem::remove(song);
+}
+
+TEST(HeadlessSimulation, SongTimeFollowsMixedSamplesOverALongRun)
+{
+	std::string song = WriteSong(125.0);
+	{
+		AudioPlayer player("", AudioOutput::NoSound);
+		Chart chart(4);
+		chart.Add(0, 44100);
+		chart.Finalise();
+
+		Simulation sim(player);
+		sim.SetChart(&chart, 44100.0);
+		player.LoadAudio(song);
+		ASSERT_TRUE(player.Advance(1));
+		ASSERT_TRUE(player.GetLoaded());
+		sim.Start();
+		player.PlayAudio();
+
+		//Two minutes of blocks, the smoothed clock against the samples the mixer has produced
+		double rate = player.GetOutputRate();
+		unsigned int blocks = (unsigned int)(120.0 * rate / player.GetBlockLength());
+		double maxError = 0.0;
+		for (unsigned int i = 0; i < blocks; i++)
+		{
+			ASSERT_TRUE(sim.Advance(1));
+			double songTime = sim.Read().SongTime;
+			double mixed = player.GetPositionSamples() / rate;
+			//The first second is the clock locking on
+			if (mixed > 1.0)
+			{
+				maxError = std::max(maxError, std::abs(songTime - mixed));
+			}
+		}
+
+		SimulationState state = sim.Read();
+		EXPECT_GT(state.SongTime, 119.0);
+		EXPECT_LT(maxError, 0.001);
+		EXPECT_LT(state.Clock.MaxDrift, 0.001);
+		sim.Stop();
+	}
+	std::filesystem::remove(song);
+}
@@ -0,0 +1,132 @@
+#include <OnBeat/Util/AudioPlayer/AudioPlayer.h>
+#include <OnBeat/Util/Input/Input.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace OnBeat;
+
+namespace
+{
+	//First channel of a wav from FMOD's wav writer, which writes 16 bit or float PCM
+	std::vector<float> ReadWav(const std::string& file)
+	{
+		std::ifstream input(file, std::ios::binary);
+		std::vector<char> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+		std::vector<float> samples;
+		if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) || std::memcmp(bytes.data() + 8, "WAVE", 4))
+			return samples;
+
+		uint16_t format = 0, channels = 0, bits = 0;
+		for (size_t chunk = 12; chunk + 8 <= bytes.size();)
+		{
+			uint32_t size = 0;
+			std::memcpy(&size, bytes.data() + chunk + 4, 4);
+			const char* data = bytes.data() + chunk + 8;
+			size = (uint32_t)std::min<size_t>(size, bytes.size() - chunk - 8);
+
+			if (!std::memcmp(bytes.data() + chunk, "fmt ", 4))
+			{
+				std::memcpy(&format, data, 2);
+				std::memcpy(&channels, data + 2, 2);
+				std::memcpy(&bits, data + 14, 2);
+			}
+			else if (!std::memcmp(bytes.data() + chunk, "data", 4) && channels)
+			{
+				size_t frame = channels * bits / 8;
+				for (size_t i = 0; i + frame <= size; i += frame)
+				{
+					if (format == 3 && bits == 32)
+					{
+						float value;
+						std::memcpy(&value, data + i, 4);
+						samples.push_back(value);
+					}
+					else if (bits == 16)
+					{
+						int16_t value;
+						std::memcpy(&value, data + i, 2);
+						samples.push_back(value / 32768.0f);
+					}
+				}
+			}
+			chunk += 8 + size + (size & 1);
+		}
+		return samples;
+	}
+
+	size_t FindOnset(const std::vector<float>& samples)
+	{
+		for (size_t i = 0; i < samples.size(); i++)
+		{
+			if (std::abs(samples[i]) > 0.01f)
+				return i;
+		}
+		return samples.size();
+	}
+
+	const std::string Hit = std::string(OB_SOURCE_DIR) + "/assets/user/skins/Default/sounds/hit.wav";
+}
+
+class HitsoundLatencyTest : public ::testing::Test
+{
+	protected:
+		std::string Output = (std::filesystem::temp_directory_path() / "OnBeatHitsoundLatency.wav").string();
+
+		void TearDown() override
+		{
+			std::filesystem::remove(Output);
+		}
+};
+
+//The wav writer mixes one block per Advance so the sample a hit lands on is exact
+TEST_F(HitsoundLatencyTest, StartsOneBlockAfterThePress)
+{
+	const unsigned int silence = 16;
+	unsigned int block = 0;
+	{
+		AudioPlayer player("", AudioOutput::WavWriter, Output);
+		ASSERT_TRUE(player.GetHeadless());
+		player.SetHitsounds({ Hit, Hit }, 1.0f);
+		ASSERT_TRUE(player.Advance(silence));
+		block = player.GetBlockLength();
+
+		ASSERT_TRUE(player.GetHitsounds().Trigger(Hitsound::Hit, Input::Now()));
+		ASSERT_TRUE(player.Advance(silence));
+		EXPECT_EQ(player.GetHitsounds().GetStats().Triggers, 1u);
+	}
+
+	std::vector<float> samples = ReadWav(Output);
+	ASSERT_GT(samples.size(), (size_t)silence * block);
+	size_t onset = FindOnset(samples);
+	ASSERT_LT(onset, samples.size()) << "Hitsound never reached the output";
+
+	//Pressed once the first silent blocks were mixed, heard the block after
+	int64_t latency = (int64_t)onset - (int64_t)silence * block;
+	RecordProperty("LatencySamples", (int)latency);
+	EXPECT_GE(latency, (int64_t)block);
+	EXPECT_LT(latency, 2 * (int64_t)block);
+}
+
+TEST_F(HitsoundLatencyTest, RewindsRingingVoicesInsteadOfDropping)
+{
+	AudioPlayer player("", AudioOutput::NoSound);
+	player.SetHitsounds({ Hit, Hit }, 1.0f);
+	ASSERT_TRUE(player.Advance(1));
+
+	//Three presses per voice in one update, the first round uses the armed voices
+	const size_t voices = OB_HITSOUND_VOICES / (size_t)Hitsound::Count;
+	for (size_t i = 0; i < voices * 3; i++)
+	{
+		ASSERT_TRUE(player.GetHitsounds().Trigger(Hitsound::Hit, Input::Now()));
+	}
+	ASSERT_TRUE(player.Advance(1));
+
+	auto stats = player.GetHitsounds().GetStats();
+	EXPECT_EQ(stats.Triggers, voices * 3);
+	EXPECT_EQ(stats.Steals, voices * 2);
+	EXPECT_EQ(stats.Dropped, 0u);
+}
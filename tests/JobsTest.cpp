@@ -0,0 +1,166 @@
+#include <OnBeat/Util/Jobs/Jobs.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace OnBeat;
+
+TEST(Jobs, WaitNeverRunsUnrelatedJobs)
+{
+	auto& jobs = JobSystem::Get();
+	std::thread::id waiter = std::this_thread::get_id();
+	std::atomic<int> stolen = 0;
+
+	//Enough slow jobs to keep every worker busy while the wait starts
+	std::vector<JobHandle> unrelated;
+	for (size_t i = 0; i < jobs.GetWorkerCount() * 8; i++)
+	{
+		unrelated.push_back(jobs.Schedule([&](JobHandle&)
+		{
+			if (std::this_thread::get_id() == waiter)
+				stolen++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}));
+	}
+
+	std::atomic<bool> ran = false;
+	JobHandle job = jobs.Schedule([&](JobHandle&) { ran = true; });
+	job.Wait();
+	EXPECT_TRUE(ran);
+	EXPECT_EQ(stolen.load(), 0);
+
+	//Waiting on them is what lets them run here
+	for (auto& handle : unrelated)
+	{
+		handle.Wait();
+	}
+}
+
+TEST(Jobs, NestedParallelForFinishes)
+{
+	auto& jobs = JobSystem::Get();
+	std::vector<uint64_t> sums(16, 0);
+
+	jobs.ParallelFor(sums.size(), [&](size_t start, size_t end)
+	{
+		for (size_t i = start; i < end; i++)
+		{
+			std::atomic<uint64_t> sum = 0;
+			jobs.ParallelFor(1000, [&](size_t from, size_t to)
+			{
+				uint64_t local = 0;
+				for (size_t n = from; n < to; n++)
+					local += n;
+				sum += local;
+			});
+			sums[i] = sum;
+		}
+	});
+
+	for (uint64_t sum : sums)
+	{
+		EXPECT_EQ(sum, 499500u);
+	}
+}
+
+TEST(Jobs, CancelledJobNeverRuns)
+{
+	auto& jobs = JobSystem::Get();
+
+	//Every worker held so the job is still queued when it is cancelled
+	std::atomic<bool> release = false;
+	std::atomic<size_t> holding = 0;
+	std::vector<JobHandle> blockers;
+	for (size_t i = 0; i < jobs.GetWorkerCount(); i++)
+	{
+		blockers.push_back(jobs.Schedule([&](JobHandle&)
+		{
+			holding++;
+			while (!release)
+				std::this_thread::yield();
+		}));
+	}
+	while (holding < jobs.GetWorkerCount())
+		std::this_thread::yield();
+
+	std::atomic<bool> ran = false;
+	JobHandle job = jobs.Schedule([&](JobHandle&) { ran = true; });
+	job.Cancel();
+	release = true;
+	job.Wait();
+	EXPECT_TRUE(job.GetFinished());
+	EXPECT_TRUE(job.GetCancelled());
+	EXPECT_FALSE(ran);
+
+	for (auto& handle : blockers)
+	{
+		handle.Wait();
+	}
+}
+
+TEST(Jobs, RunningJobSeesCancel)
+{
+	auto& jobs = JobSystem::Get();
+	std::atomic<bool> started = false;
+	JobHandle job = jobs.Schedule([&](JobHandle& self)
+	{
+		started = true;
+		while (!self.GetCancelled())
+			std::this_thread::yield();
+	});
+
+	//Waiting would run it here and never return, so let a worker take it
+	while (!started)
+		std::this_thread::yield();
+	job.Cancel();
+	job.Wait();
+	EXPECT_TRUE(job.GetFinished());
+}
+
+TEST(Jobs, ContinuationsRunOnTheMainThreadInOrder)
+{
+	auto& jobs = JobSystem::Get();
+	std::thread::id main = std::this_thread::get_id();
+	std::vector<int> order;
+	bool offMain = false;
+	auto record = [&](int step)
+	{
+		return [&, step]()
+		{
+			offMain |= std::this_thread::get_id() != main;
+			order.push_back(step);
+		};
+	};
+
+	std::atomic<bool> release = false;
+	JobHandle job = jobs.Schedule([&](JobHandle&)
+	{
+		while (!release)
+			std::this_thread::yield();
+	});
+	job.Then(record(1)).Then(record(2));
+	release = true;
+	job.Wait();
+	//Added after the job finished, posted straight away behind the others
+	job.Then(record(3));
+
+	JobHandle cancelled = jobs.Schedule([](JobHandle&) {});
+	cancelled.Then(record(4));
+	cancelled.Cancel();
+	cancelled.Wait();
+
+	//The finishing worker posts continuations just after waking the waiter
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (order.size() < 3 && std::chrono::steady_clock::now() < deadline)
+	{
+		jobs.RunMainThread();
+		std::this_thread::yield();
+	}
+	jobs.RunMainThread();
+
+	EXPECT_EQ(order, (std::vector<int>{ 1, 2, 3 }));
+	EXPECT_FALSE(offMain);
+}
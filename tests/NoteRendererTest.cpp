@@ -0,0 +1,122 @@
+#include <OnBeat/App/MusicLayer/NoteRenderer/NoteRenderer.h>
+#include <Hazel/Renderer/RenderCommand.h>
+#include <Support/HeadlessGL.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace OnBeat;
+
+//Draws charts with the game's NoteRenderer on a software driver in CI, the engine is the stand-in in tests/include
+class NoteRendererTest : public ::testing::Test
+{
+	protected:
+		static constexpr int Size = 64;
+		static constexpr uint32_t Red = 0xff0000ff;
+		static constexpr uint32_t Green = 0xff00ff00;
+		static constexpr uint32_t Black = 0xff000000;
+
+		void SetUp() override
+		{
+			if (!GL.IsValid())
+			{
+				GTEST_SKIP() << "No headless GL driver";
+			}
+
+			//Lanes are 0.8 wide and 0.2 tall at x = -1.5, -0.5, 0.5, 1.5
+			std::vector<Skin::MusicSkin::Lane> lanes(4);
+			for (int l = 0; l < 4; l++)
+			{
+				lanes[l].X = -1.5f + l;
+				lanes[l].BeatSize = { 0.8f, 0.2f };
+			}
+			Notes.SetLanes(lanes);
+			Notes.SetBeat(Skin::DrawCommand(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)));
+		}
+
+		void Draw(float velocity, float offset)
+		{
+			Hazel::RenderCommand::SetClearColor({ 0.0f, 0.0f, 0.0f, 1.0f });
+			Hazel::RenderCommand::Clear();
+			Notes.Draw(Camera, velocity, offset);
+			GL.Finish();
+			ASSERT_EQ(glGetError(), (GLenum)GL_NO_ERROR);
+		}
+
+		//Pixel under a world space point
+		uint32_t At(float x, float y)
+		{
+			return GL.ReadPixel((int)((x + 2.0f) / 4.0f * Size), (int)((y + 2.0f) / 4.0f * Size));
+		}
+
+		OnBeat::Test::HeadlessGL GL{ Size, Size };
+		//World space is [-2, 2] on both axes
+		Hazel::OrthographicCamera Camera{ -2.0f, 2.0f, -2.0f, 2.0f };
+		NoteRenderer Notes;
+};
+
+TEST_F(NoteRendererTest, PlacesNotesByLaneAndTime)
+{
+	Chart chart(4);
+	chart.Add(0, 1000);
+	chart.Add(3, 2000);
+	chart.Finalise();
+	Notes.Upload(chart, 1000.0);
+	EXPECT_EQ(Notes.GetNoteCount(), 2u);
+
+	//Notes sit at time * velocity + offset
+	Draw(1.0f, -1.5f);
+	EXPECT_EQ(At(-1.5f, -0.5f), Red);
+	EXPECT_EQ(At(1.5f, 0.5f), Red);
+	EXPECT_EQ(At(-1.5f, 0.5f), Black);
+	EXPECT_EQ(At(1.5f, -0.5f), Black);
+	EXPECT_EQ(At(-0.5f, -0.5f), Black);
+	EXPECT_EQ(At(0.5f, 0.5f), Black);
+	//Lane width 0.8 leaves a gap between neighbouring lanes
+	EXPECT_EQ(At(-1.0f, -0.5f), Black);
+}
+
+TEST_F(NoteRendererTest, ScrollsWithUniformsOnly)
+{
+	Chart chart(4);
+	chart.Add(1, 500);
+	chart.Finalise();
+	Notes.Upload(chart, 1000.0);
+
+	Draw(2.0f, -1.0f);
+	EXPECT_EQ(At(-0.5f, 0.0f), Red);
+
+	//Same buffer, a later song time only moves the offset
+	Draw(2.0f, -2.5f);
+	EXPECT_EQ(At(-0.5f, 0.0f), Black);
+	EXPECT_EQ(At(-0.5f, -1.5f), Red);
+}
+
+TEST_F(NoteRendererTest, TintsTexturedBeats)
+{
+	Chart chart(4);
+	chart.Add(2, 1000);
+	chart.Finalise();
+	Notes.Upload(chart, 1000.0);
+
+	uint32_t white = 0xffffffff;
+	auto texture = Hazel::Texture2D::Create(1, 1);
+	texture->SetData(&white, sizeof(uint32_t));
+	Skin::DrawCommand beat;
+	beat.Texture = texture;
+	beat.Tint = { 0.0f, 1.0f, 0.0f, 1.0f };
+	Notes.SetBeat(beat);
+
+	Draw(1.0f, -1.0f);
+	EXPECT_EQ(At(0.5f, 0.0f), Green);
+}
+
+TEST_F(NoteRendererTest, EmptyChartDrawsNothing)
+{
+	Chart chart(4);
+	chart.Finalise();
+	Notes.Upload(chart, 1000.0);
+	EXPECT_EQ(Notes.GetNoteCount(), 0u);
+
+	Draw(1.0f, 0.0f);
+	EXPECT_EQ(At(-1.5f, 0.0f), Black);
+}
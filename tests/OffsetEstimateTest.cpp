@@ -0,0 +1,69 @@
+#include <OnBeat/App/CalibrationLayer/OffsetEstimate/OffsetEstimate.h>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace OnBeat;
+
+TEST(OffsetEstimate, ConstantOffset)
+{
+	std::vector<double> offsets(16, 0.035);
+	OffsetEstimate estimate = OffsetEstimate::Estimate(offsets);
+
+	EXPECT_DOUBLE_EQ(estimate.Offset, 0.035);
+	EXPECT_DOUBLE_EQ(estimate.Spread, 0.0);
+	EXPECT_EQ(estimate.Used, 16u);
+	EXPECT_EQ(estimate.Rejected, 0u);
+	EXPECT_TRUE(estimate.Valid);
+}
+
+TEST(OffsetEstimate, RejectsOutliers)
+{
+	//Steady taps 40ms late with a few missed beats and double taps far from the rest
+	std::mt19937 random(44);
+	std::normal_distribution<double> jitter(0.04, 0.004);
+	std::vector<double> offsets;
+	for (int i = 0; i < 20; i++)
+	{
+		offsets.push_back(jitter(random));
+	}
+	offsets.push_back(0.45);
+	offsets.push_back(-0.25);
+	offsets.push_back(0.2);
+
+	OffsetEstimate estimate = OffsetEstimate::Estimate(offsets);
+	EXPECT_NEAR(estimate.Offset, 0.04, 0.003);
+	EXPECT_NEAR(estimate.Spread, 0.004, 0.002);
+	EXPECT_EQ(estimate.Rejected, 3u);
+	EXPECT_EQ(estimate.Used, 20u);
+	EXPECT_TRUE(estimate.Valid);
+}
+
+TEST(OffsetEstimate, TooFewTapsIsInvalid)
+{
+	OffsetEstimate estimate = OffsetEstimate::Estimate({ 0.02, 0.021, 0.019, 0.02, 0.022, 0.018, 0.02 });
+	EXPECT_NEAR(estimate.Offset, 0.02, 0.0005);
+	EXPECT_EQ(estimate.Used, 7u);
+	EXPECT_FALSE(estimate.Valid);
+
+	EXPECT_FALSE(OffsetEstimate::Estimate({}).Valid);
+	EXPECT_EQ(OffsetEstimate::Estimate({}).Used, 0u);
+}
+
+TEST(OffsetEstimate, TapsOffTheBeatAreInvalid)
+{
+	//Enough steady taps, but over a quarter of them nowhere near the beat
+	std::vector<double> offsets;
+	for (int i = 0; i < 10; i++)
+	{
+		offsets.push_back(0.03 + (i % 3) * 0.001);
+	}
+	for (double stray : { -0.2, -0.15, 0.18, 0.22, 0.25, 0.3 })
+	{
+		offsets.push_back(stray);
+	}
+
+	OffsetEstimate estimate = OffsetEstimate::Estimate(offsets);
+	EXPECT_EQ(estimate.Used, 10u);
+	EXPECT_EQ(estimate.Rejected, 6u);
+	EXPECT_FALSE(estimate.Valid);
+}
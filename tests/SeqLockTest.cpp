@@ -0,0 +1,73 @@
+#include <OnBeat/Util/Queue/SeqLock.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace OnBeat;
+
+namespace
+{
+	//Every field is derived from the first so a torn read shows up as a mismatch
+	struct Snapshot
+	{
+		uint64_t Count = 0;
+		double Seconds = 0.0;
+		uint64_t Square = 0;
+		bool Odd = false;
+	};
+
+	Snapshot Make(uint64_t count)
+	{
+		return { count, count / 1000.0, count * count, (count & 1) != 0 };
+	}
+}
+
+TEST(SeqLockTest, StartsWithDefaultValue)
+{
+	SeqLock<Snapshot> lock;
+	Snapshot value = lock.Read();
+	EXPECT_EQ(value.Count, 0u);
+	EXPECT_EQ(value.Seconds, 0.0);
+	EXPECT_FALSE(value.Odd);
+}
+
+TEST(SeqLockTest, ReadersNeverSeeTornValues)
+{
+	SeqLock<Snapshot> lock;
+	std::atomic<bool> done = false;
+	std::atomic<uint64_t> torn = 0;
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 3; i++)
+	{
+		readers.emplace_back([&]()
+		{
+			uint64_t last = 0;
+			while (!done.load(std::memory_order_acquire))
+			{
+				Snapshot value = lock.Read();
+				Snapshot expected = Make(value.Count);
+				if (value.Seconds != expected.Seconds || value.Square != expected.Square ||
+					value.Odd != expected.Odd || value.Count < last)
+				{
+					torn++;
+				}
+				last = value.Count;
+			}
+		});
+	}
+
+	for (uint64_t count = 1; count <= 1000000; count++)
+	{
+		lock.Publish(Make(count));
+	}
+	done = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	EXPECT_EQ(torn.load(), 0u);
+	EXPECT_EQ(lock.Read().Count, 1000000u);
+}
@@ -0,0 +1,123 @@
+#include <OnBeat/App/MusicLayer/SessionCache/SessionCache.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace OnBeat;
+
+namespace
+{
+	std::shared_ptr<SongSession> CreateSession(size_t soundBytes, int notes = 0)
+	{
+		auto session = std::make_shared<SongSession>();
+		for (auto& chart : session->Charts)
+		{
+			chart = Chart(4);
+			for (int n = 0; n < notes; n++)
+			{
+				chart.Add(n % 4, n * 100);
+			}
+			chart.Finalise();
+		}
+		session->SoundBytes = soundBytes;
+		return session;
+	}
+}
+
+TEST(SessionCache, EvictsLeastRecentlyUsed)
+{
+	SessionCache cache(3);
+	std::vector<std::string> evicted;
+	cache.SetEvictCallback([&](const std::string& file) { evicted.push_back(file); });
+
+	cache.Store("a", "a.mp3", CreateSession(0));
+	cache.Store("b", "b.mp3", CreateSession(0));
+	cache.Store("c", "c.mp3", CreateSession(0));
+	//A replay of a makes b the oldest
+	ASSERT_NE(cache.Find("a"), nullptr);
+	cache.Store("d", "d.mp3", CreateSession(0));
+
+	EXPECT_FALSE(cache.Contains("b"));
+	EXPECT_TRUE(cache.Contains("a"));
+	EXPECT_TRUE(cache.Contains("c"));
+	EXPECT_TRUE(cache.Contains("d"));
+	EXPECT_EQ(evicted, (std::vector<std::string>{ "b.mp3" }));
+	EXPECT_EQ(cache.Find("b"), nullptr);
+
+	const SessionCache::Statistics& stats = cache.GetStats();
+	EXPECT_EQ(stats.Hits, 1u);
+	EXPECT_EQ(stats.Misses, 1u);
+	EXPECT_EQ(stats.Evictions, 1u);
+	EXPECT_EQ(stats.Songs, 3u);
+}
+
+TEST(SessionCache, KeepsWithinByteBudget)
+{
+	size_t song = CreateSession(1000, 8)->GetBytes();
+	SessionCache cache(8, song * 2 + song / 2);
+	std::vector<std::string> evicted;
+	cache.SetEvictCallback([&](const std::string& file) { evicted.push_back(file); });
+
+	cache.Store("a", "a.mp3", CreateSession(1000, 8));
+	cache.Store("b", "b.mp3", CreateSession(1000, 8));
+	EXPECT_EQ(cache.GetStats().Bytes, song * 2);
+	cache.Store("c", "c.mp3", CreateSession(1000, 8));
+
+	EXPECT_EQ(evicted, (std::vector<std::string>{ "a.mp3" }));
+	EXPECT_EQ(cache.GetStats().Bytes, song * 2);
+	EXPECT_EQ(cache.GetStats().Songs, 2u);
+
+	//The newest song stays even when it alone is over budget
+	cache.Store("d", "d.mp3", CreateSession(song * 4));
+	EXPECT_TRUE(cache.Contains("d"));
+	EXPECT_EQ(cache.GetStats().Songs, 1u);
+	EXPECT_EQ(evicted, (std::vector<std::string>{ "a.mp3", "b.mp3", "c.mp3" }));
+}
+
+TEST(SessionCache, SoundBytesReplaceTheEstimate)
+{
+	size_t estimate = CreateSession(1000)->GetBytes();
+	SessionCache cache(8, estimate * 3);
+	std::vector<std::string> evicted;
+	cache.SetEvictCallback([&](const std::string& file) { evicted.push_back(file); });
+
+	cache.Store("a", "a.mp3", CreateSession(1000));
+	cache.Store("b", "b.mp3", CreateSession(1000));
+	EXPECT_EQ(cache.GetStats().Bytes, estimate * 2);
+
+	//The decoded sound came out smaller than analysis guessed
+	cache.SetSoundBytes("b", 400);
+	EXPECT_EQ(cache.GetStats().Bytes, estimate * 2 - 600);
+
+	//Then one far bigger, which pushes the oldest out
+	cache.SetSoundBytes("b", estimate * 2);
+	EXPECT_FALSE(cache.Contains("a"));
+	EXPECT_EQ(evicted, (std::vector<std::string>{ "a.mp3" }));
+	EXPECT_EQ(cache.GetStats().Bytes, estimate - 1000 + estimate * 2);
+
+	//Unknown keys are ignored
+	cache.SetSoundBytes("missing", 1);
+	EXPECT_EQ(cache.GetStats().Songs, 1u);
+}
+
+TEST(SessionCache, EvictCallbackWaitsForTheLastSessionOfAFile)
+{
+	SessionCache cache(2);
+	std::vector<std::string> evicted;
+	cache.SetEvictCallback([&](const std::string& file) { evicted.push_back(file); });
+
+	//The same song analysed with two option sets shares one sound
+	cache.Store("song|easy", "song.mp3", CreateSession(0));
+	cache.Store("song|hard", "song.mp3", CreateSession(0));
+	cache.Store("other", "other.mp3", CreateSession(0));
+	EXPECT_TRUE(evicted.empty());
+	EXPECT_EQ(cache.GetStats().Evictions, 1u);
+
+	cache.Store("third", "third.mp3", CreateSession(0));
+	EXPECT_EQ(evicted, (std::vector<std::string>{ "song.mp3" }));
+
+	cache.Clear();
+	EXPECT_EQ(evicted, (std::vector<std::string>{ "song.mp3", "other.mp3", "third.mp3" }));
+	EXPECT_EQ(cache.GetStats().Songs, 0u);
+	EXPECT_EQ(cache.GetStats().Bytes, 0u);
+}
@@ -0,0 +1,175 @@
+#include <Support/HeadlessGL.h>
+#include <Hazel/Core/Log.h>
+#include <EGL/eglext.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace OnBeat
+{
+	namespace Test
+	{
+		HeadlessGL::HeadlessGL(int width, int height)
+			: Width(width), Height(height)
+		{
+			//Surfaceless needs no window system so it also works on build machines
+			auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+			Display = getPlatformDisplay
+				? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+				: eglGetDisplay(EGL_DEFAULT_DISPLAY);
+			if (Display == EGL_NO_DISPLAY || !eglInitialize(Display, nullptr, nullptr))
+			{
+				HZ_WARN("No EGL display available");
+				Display = EGL_NO_DISPLAY;
+				return;
+			}
+
+			//Same core profile Hazel asks GLFW for
+			const EGLint attributes[] = {
+				EGL_CONTEXT_MAJOR_VERSION, 3,
+				EGL_CONTEXT_MINOR_VERSION, 3,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+				EGL_NONE
+			};
+			if (!eglBindAPI(EGL_OPENGL_API) ||
+				(Context = eglCreateContext(Display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes)) == EGL_NO_CONTEXT ||
+				!eglMakeCurrent(Display, EGL_NO_SURFACE, EGL_NO_SURFACE, Context))
+			{
+				HZ_WARN("Could not create a GL 3.3 context, EGL error {0:#x}", eglGetError());
+				return;
+			}
+			Renderer = (const char*)glGetString(GL_RENDERER);
+
+			glGenTextures(1, &Colour);
+			glBindTexture(GL_TEXTURE_2D, Colour);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+			glGenFramebuffers(1, &Framebuffer);
+			glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Colour, 0);
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				HZ_WARN("Offscreen framebuffer incomplete");
+				glDeleteFramebuffers(1, &Framebuffer);
+				Framebuffer = 0;
+				return;
+			}
+			glViewport(0, 0, width, height);
+		}
+
+		HeadlessGL::~HeadlessGL()
+		{
+			if (Framebuffer)
+			{
+				glDeleteFramebuffers(1, &Framebuffer);
+			}
+			if (Colour)
+			{
+				glDeleteTextures(1, &Colour);
+			}
+			if (Context != EGL_NO_CONTEXT)
+			{
+				eglMakeCurrent(Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+				eglDestroyContext(Display, Context);
+			}
+			if (Display != EGL_NO_DISPLAY)
+			{
+				eglTerminate(Display);
+			}
+		}
+
+		uint32_t HeadlessGL::ReadPixel(int x, int y)
+		{
+			uint32_t pixel = 0;
+			glReadPixels(x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &pixel);
+			return pixel;
+		}
+
+		void HeadlessGL::Finish()
+		{
+			glFinish();
+		}
+
+		static GLuint CompileStage(GLenum type, const std::string& source)
+		{
+			GLuint shader = glCreateShader(type);
+			const char* text = source.c_str();
+			glShaderSource(shader, 1, &text, nullptr);
+			glCompileShader(shader);
+
+			GLint compiled = GL_FALSE;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+			if (!compiled)
+			{
+				GLint length = 0;
+				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+				std::vector<char> log(length + 1, '\0');
+				glGetShaderInfoLog(shader, length, nullptr, log.data());
+				HZ_ERROR("Shader compilation failed: {0}", log.data());
+				glDeleteShader(shader);
+				return 0;
+			}
+			return shader;
+		}
+
+		GLuint LoadShader(const std::string& file)
+		{
+			std::ifstream input(file);
+			if (!input)
+			{
+				HZ_ERROR("Could not open shader {0}", file);
+				return 0;
+			}
+			std::stringstream buffer;
+			buffer << input.rdbuf();
+			std::string source = buffer.str();
+
+			//Split the same way Hazel's OpenGLShader does
+			const std::string token = "#type";
+			std::string stages[2];
+			size_t pos = source.find(token);
+			while (pos != std::string::npos)
+			{
+				size_t eol = source.find_first_of("\r\n", pos);
+				std::string type = source.substr(pos + token.size() + 1, eol - pos - token.size() - 1);
+				size_t begin = source.find_first_not_of("\r\n", eol);
+				pos = source.find(token, begin);
+				std::string stage = source.substr(begin, pos == std::string::npos ? std::string::npos : pos - begin);
+				if (type == "vertex")
+				{
+					stages[0] = stage;
+				}
+				else if (type == "fragment" || type == "pixel")
+				{
+					stages[1] = stage;
+				}
+			}
+
+			GLuint vertex = CompileStage(GL_VERTEX_SHADER, stages[0]);
+			GLuint fragment = CompileStage(GL_FRAGMENT_SHADER, stages[1]);
+			if (!vertex || !fragment)
+			{
+				glDeleteShader(vertex);
+				glDeleteShader(fragment);
+				return 0;
+			}
+
+			GLuint program = glCreateProgram();
+			glAttachShader(program, vertex);
+			glAttachShader(program, fragment);
+			glLinkProgram(program);
+			glDeleteShader(vertex);
+			glDeleteShader(fragment);
+
+			GLint linked = GL_FALSE;
+			glGetProgramiv(program, GL_LINK_STATUS, &linked);
+			if (!linked)
+			{
+				HZ_ERROR("Shader {0} failed to link", file);
+				glDeleteProgram(program);
+				return 0;
+			}
+			return program;
+		}
+	}
+}
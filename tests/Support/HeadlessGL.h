@@ -0,0 +1,45 @@
+#pragma once
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <cstdint>
+#include <string>
+
+namespace OnBeat
+{
+	namespace Test
+	{
+		//Surfaceless EGL context drawing into an offscreen RGBA8 framebuffer
+		//Without a usable driver IsValid is false and GL tests skip themselves
+		class HeadlessGL
+		{
+			public:
+				HeadlessGL(int width, int height);
+				~HeadlessGL();
+
+				bool IsValid() const { return Framebuffer != 0; }
+				const std::string& GetRenderer() const { return Renderer; }
+
+				//Packed as 0xAABBGGRR, origin at the bottom left like glReadPixels
+				uint32_t ReadPixel(int x, int y);
+				//Blocks until every queued command has run
+				void Finish();
+
+				int GetWidth() const { return Width; }
+				int GetHeight() const { return Height; }
+
+			private:
+				EGLDisplay Display = EGL_NO_DISPLAY;
+				EGLContext Context = EGL_NO_CONTEXT;
+				GLuint Framebuffer = 0;
+				GLuint Colour = 0;
+				int Width;
+				int Height;
+				std::string Renderer;
+		};
+
+		//Compiles a Hazel shader file split into "#type vertex" and "#type fragment" sections, 0 on failure
+		GLuint LoadShader(const std::string& file);
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <memory>
+#include <utility>
+
+//Stands in for the engine's Base.h when units are built without it
+namespace Hazel
+{
+	template<typename T>
+	using Ref = std::shared_ptr<T>;
+
+	template<typename T, typename... Args>
+	constexpr Ref<T> CreateRef(Args&&... args)
+	{
+		return std::make_shared<T>(std::forward<Args>(args)...);
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <fmt/format.h>
+#include <cstdio>
+
+//Stands in for Hazel's spdlog loggers when units are built without the engine
+#define OB_TEST_LOG(level, ...) fmt::print(stderr, "[{0}] {1}\n", level, fmt::format(__VA_ARGS__))
+
+#define HZ_TRACE(...) ((void)0)
+#define HZ_INFO(...) OB_TEST_LOG("info", __VA_ARGS__)
+#define HZ_WARN(...) OB_TEST_LOG("warn", __VA_ARGS__)
+#define HZ_ERROR(...) OB_TEST_LOG("error", __VA_ARGS__)
+#define HZ_CRITICAL(...) OB_TEST_LOG("critical", __VA_ARGS__)
@@ -0,0 +1,119 @@
+#pragma once
+#include <Hazel/Core/Base.h>
+#include <Support/HeadlessGL.h>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+//The engine's vertex and index buffers on the headless GL context, float and int attributes only
+namespace Hazel
+{
+	enum class ShaderDataType
+	{
+		None = 0, Float, Float2, Float3, Float4, Int, Int2, Int3, Int4
+	};
+
+	inline uint32_t ShaderDataTypeComponents(ShaderDataType type)
+	{
+		switch (type)
+		{
+			case ShaderDataType::Float: case ShaderDataType::Int: return 1;
+			case ShaderDataType::Float2: case ShaderDataType::Int2: return 2;
+			case ShaderDataType::Float3: case ShaderDataType::Int3: return 3;
+			case ShaderDataType::Float4: case ShaderDataType::Int4: return 4;
+			default: return 0;
+		}
+	}
+
+	struct BufferElement
+	{
+		std::string Name;
+		ShaderDataType Type;
+		uint32_t Size;
+		size_t Offset = 0;
+		bool Normalized;
+
+		BufferElement(ShaderDataType type, const std::string& name, bool normalized = false)
+			: Name(name), Type(type), Size(ShaderDataTypeComponents(type) * 4), Normalized(normalized)
+		{
+		}
+
+		uint32_t GetComponentCount() const { return ShaderDataTypeComponents(Type); }
+	};
+
+	class BufferLayout
+	{
+		public:
+			BufferLayout() = default;
+			BufferLayout(std::initializer_list<BufferElement> elements)
+				: Elements(elements)
+			{
+				for (auto& element : Elements)
+				{
+					element.Offset = Stride;
+					Stride += element.Size;
+				}
+			}
+
+			uint32_t GetStride() const { return Stride; }
+			const std::vector<BufferElement>& GetElements() const { return Elements; }
+
+		private:
+			std::vector<BufferElement> Elements;
+			uint32_t Stride = 0;
+	};
+
+	class VertexBuffer
+	{
+		public:
+			VertexBuffer(const void* vertices, uint32_t size, GLenum usage)
+			{
+				glGenBuffers(1, &RendererID);
+				glBindBuffer(GL_ARRAY_BUFFER, RendererID);
+				glBufferData(GL_ARRAY_BUFFER, size, vertices, usage);
+			}
+
+			~VertexBuffer() { glDeleteBuffers(1, &RendererID); }
+
+			static Ref<VertexBuffer> Create(uint32_t size) { return CreateRef<VertexBuffer>(nullptr, size, GL_DYNAMIC_DRAW); }
+			static Ref<VertexBuffer> Create(float* vertices, uint32_t size) { return CreateRef<VertexBuffer>(vertices, size, GL_STATIC_DRAW); }
+
+			void Bind() const { glBindBuffer(GL_ARRAY_BUFFER, RendererID); }
+			void SetData(const void* data, uint32_t size)
+			{
+				glBindBuffer(GL_ARRAY_BUFFER, RendererID);
+				glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+			}
+
+			const BufferLayout& GetLayout() const { return Layout; }
+			void SetLayout(const BufferLayout& layout) { Layout = layout; }
+
+		private:
+			GLuint RendererID = 0;
+			BufferLayout Layout;
+	};
+
+	class IndexBuffer
+	{
+		public:
+			IndexBuffer(uint32_t* indices, uint32_t count)
+				: Count(count)
+			{
+				glGenBuffers(1, &RendererID);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, RendererID);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+			}
+
+			~IndexBuffer() { glDeleteBuffers(1, &RendererID); }
+
+			static Ref<IndexBuffer> Create(uint32_t* indices, uint32_t count) { return CreateRef<IndexBuffer>(indices, count); }
+
+			void Bind() const { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, RendererID); }
+			uint32_t GetCount() const { return Count; }
+
+		private:
+			GLuint RendererID = 0;
+			uint32_t Count;
+	};
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+//The engine's OrthographicCamera, fixed at the origin
+namespace Hazel
+{
+	class OrthographicCamera
+	{
+		public:
+			OrthographicCamera(float left, float right, float bottom, float top)
+				: ViewProjection(glm::ortho(left, right, bottom, top, -1.0f, 1.0f))
+			{
+			}
+
+			const glm::mat4& GetViewProjectionMatrix() const { return ViewProjection; }
+
+		private:
+			glm::mat4 ViewProjection;
+	};
+}
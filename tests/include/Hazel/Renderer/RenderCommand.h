@@ -0,0 +1,21 @@
+#pragma once
+#include <Hazel/Renderer/VertexArray.h>
+#include <glm/glm.hpp>
+
+//The engine's RenderCommand on the headless GL context
+namespace Hazel
+{
+	class RenderCommand
+	{
+		public:
+			static void SetClearColor(const glm::vec4& colour) { glClearColor(colour.x, colour.y, colour.z, colour.w); }
+			static void Clear() { glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); }
+
+			static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t count = 0)
+			{
+				vertexArray->Bind();
+				count = count ? count : vertexArray->GetIndexBuffer()->GetCount();
+				glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+			}
+	};
+}
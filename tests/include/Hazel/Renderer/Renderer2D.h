@@ -0,0 +1,214 @@
+#pragma once
+#include <Hazel/Renderer/OrthographicCamera.h>
+#include <Hazel/Renderer/RenderCommand.h>
+#include <Hazel/Renderer/Shader.h>
+#include <Hazel/Renderer/Texture.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <array>
+#include <vector>
+
+//The engine's batch renderer on the headless GL context, same vertex work per quad and the same Texture.glsl
+namespace Hazel
+{
+	class Renderer2D
+	{
+		public:
+			struct Statistics
+			{
+				uint32_t DrawCalls = 0;
+				uint32_t QuadCount = 0;
+			};
+
+			static void Init()
+			{
+				Data& data = Get();
+				data.QuadVertexArray = VertexArray::Create();
+				data.QuadVertexBuffer = VertexBuffer::Create(MaxVertices * sizeof(QuadVertex));
+				data.QuadVertexBuffer->SetLayout({
+					{ ShaderDataType::Float3, "a_Position" },
+					{ ShaderDataType::Float4, "a_Color" },
+					{ ShaderDataType::Float2, "a_TexCoord" },
+					{ ShaderDataType::Float, "a_TexIndex" },
+					{ ShaderDataType::Float, "a_TilingFactor" }
+				});
+				data.QuadVertexArray->AddVertexBuffer(data.QuadVertexBuffer);
+				data.Vertices.resize(MaxVertices);
+
+				std::vector<uint32_t> indices(MaxIndices);
+				for (uint32_t i = 0, offset = 0; i < MaxIndices; i += 6, offset += 4)
+				{
+					const uint32_t quad[6] = { 0, 1, 2, 2, 3, 0 };
+					for (int v = 0; v < 6; v++)
+					{
+						indices[i + v] = offset + quad[v];
+					}
+				}
+				data.QuadVertexArray->SetIndexBuffer(IndexBuffer::Create(indices.data(), MaxIndices));
+
+				uint32_t white = 0xffffffff;
+				data.WhiteTexture = Texture2D::Create(1, 1);
+				data.WhiteTexture->SetData(&white, sizeof(uint32_t));
+
+				int samplers[MaxTextureSlots];
+				for (int i = 0; i < (int)MaxTextureSlots; i++)
+				{
+					samplers[i] = i;
+				}
+				data.TextureShader = Shader::Create("assets/shaders/Texture.glsl");
+				data.TextureShader->Bind();
+				data.TextureShader->SetIntArray("u_Textures", samplers, MaxTextureSlots);
+				data.TextureSlots[0] = data.WhiteTexture;
+			}
+
+			static void Shutdown()
+			{
+				Get() = Data();
+			}
+
+			static void BeginScene(const OrthographicCamera& camera)
+			{
+				Data& data = Get();
+				data.TextureShader->Bind();
+				data.TextureShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+				StartBatch();
+			}
+
+			static void EndScene()
+			{
+				Flush();
+			}
+
+			static void Flush()
+			{
+				Data& data = Get();
+				if (data.QuadIndexCount == 0)
+					return;
+
+				data.QuadVertexBuffer->SetData(data.Vertices.data(), data.QuadCount * 4 * sizeof(QuadVertex));
+				for (uint32_t i = 0; i < data.TextureSlotIndex; i++)
+				{
+					data.TextureSlots[i]->Bind(i);
+				}
+				RenderCommand::DrawIndexed(data.QuadVertexArray, data.QuadIndexCount);
+				data.Stats.DrawCalls++;
+			}
+
+			static void DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& colour)
+			{
+				SubmitQuad(Transform(position, size), 0.0f, 1.0f, colour);
+			}
+
+			static void DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture,
+				float tilingFactor = 1.0f, const glm::vec4& tint = glm::vec4(1.0f))
+			{
+				Data& data = Get();
+				if (data.QuadIndexCount >= MaxIndices)
+					NextBatch();
+
+				float textureIndex = 0.0f;
+				for (uint32_t i = 1; i < data.TextureSlotIndex; i++)
+				{
+					if (*data.TextureSlots[i] == *texture)
+					{
+						textureIndex = (float)i;
+						break;
+					}
+				}
+				if (textureIndex == 0.0f)
+				{
+					if (data.TextureSlotIndex >= MaxTextureSlots)
+						NextBatch();
+					textureIndex = (float)data.TextureSlotIndex;
+					data.TextureSlots[data.TextureSlotIndex++] = texture;
+				}
+				SubmitQuad(Transform(position, size), textureIndex, tilingFactor, tint);
+			}
+
+			static void ResetStats() { Get().Stats = Statistics(); }
+			static Statistics GetStats() { return Get().Stats; }
+
+		private:
+			struct QuadVertex
+			{
+				glm::vec3 Position;
+				glm::vec4 Colour;
+				glm::vec2 TexCoord;
+				float TexIndex;
+				float TilingFactor;
+			};
+
+			static constexpr uint32_t MaxQuads = 20000;
+			static constexpr uint32_t MaxVertices = MaxQuads * 4;
+			static constexpr uint32_t MaxIndices = MaxQuads * 6;
+			static constexpr uint32_t MaxTextureSlots = 32;
+
+			struct Data
+			{
+				Ref<VertexArray> QuadVertexArray;
+				Ref<VertexBuffer> QuadVertexBuffer;
+				Ref<Shader> TextureShader;
+				Ref<Texture2D> WhiteTexture;
+
+				std::vector<QuadVertex> Vertices;
+				uint32_t QuadCount = 0;
+				uint32_t QuadIndexCount = 0;
+
+				std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
+				uint32_t TextureSlotIndex = 1;
+
+				Statistics Stats;
+			};
+
+			static Data& Get()
+			{
+				static Data data;
+				return data;
+			}
+
+			static glm::mat4 Transform(const glm::vec3& position, const glm::vec2& size)
+			{
+				return glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+			}
+
+			static void StartBatch()
+			{
+				Data& data = Get();
+				data.QuadCount = 0;
+				data.QuadIndexCount = 0;
+				data.TextureSlotIndex = 1;
+			}
+
+			static void NextBatch()
+			{
+				Flush();
+				StartBatch();
+			}
+
+			static void SubmitQuad(const glm::mat4& transform, float textureIndex, float tilingFactor, const glm::vec4& colour)
+			{
+				static const glm::vec4 corners[4] = {
+					{ -0.5f, -0.5f, 0.0f, 1.0f }, { 0.5f, -0.5f, 0.0f, 1.0f }, { 0.5f, 0.5f, 0.0f, 1.0f }, { -0.5f, 0.5f, 0.0f, 1.0f }
+				};
+				static const glm::vec2 texCoords[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+				Data& data = Get();
+				if (data.QuadIndexCount >= MaxIndices)
+					NextBatch();
+
+				QuadVertex* vertex = &data.Vertices[data.QuadCount * 4];
+				for (int v = 0; v < 4; v++, vertex++)
+				{
+					glm::vec4 position = transform * corners[v];
+					vertex->Position = { position.x, position.y, position.z };
+					vertex->Colour = colour;
+					vertex->TexCoord = texCoords[v];
+					vertex->TexIndex = textureIndex;
+					vertex->TilingFactor = tilingFactor;
+				}
+				data.QuadCount++;
+				data.QuadIndexCount += 6;
+				data.Stats.QuadCount++;
+			}
+	};
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <Hazel/Core/Base.h>
+#include <Support/HeadlessGL.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <string>
+
+//The engine's Shader on the headless GL context, files are split by Test::LoadShader as OpenGLShader does
+namespace Hazel
+{
+	class Shader
+	{
+		public:
+			Shader(const std::string& file)
+				: RendererID(OnBeat::Test::LoadShader(file))
+			{
+			}
+
+			~Shader() { glDeleteProgram(RendererID); }
+
+			static Ref<Shader> Create(const std::string& file) { return CreateRef<Shader>(file); }
+
+			bool IsValid() const { return RendererID != 0; }
+			void Bind() const { glUseProgram(RendererID); }
+
+			void SetInt(const std::string& name, int value) { glUniform1i(Location(name), value); }
+			void SetIntArray(const std::string& name, int* values, uint32_t count) { glUniform1iv(Location(name), count, values); }
+			void SetFloat(const std::string& name, float value) { glUniform1f(Location(name), value); }
+			void SetFloat3(const std::string& name, const glm::vec3& value) { glUniform3f(Location(name), value.x, value.y, value.z); }
+			void SetFloat4(const std::string& name, const glm::vec4& value) { glUniform4f(Location(name), value.x, value.y, value.z, value.w); }
+			void SetMat4(const std::string& name, const glm::mat4& value) { glUniformMatrix4fv(Location(name), 1, GL_FALSE, glm::value_ptr(value)); }
+
+		private:
+			GLint Location(const std::string& name) const { return glGetUniformLocation(RendererID, name.c_str()); }
+
+			GLuint RendererID;
+	};
+}
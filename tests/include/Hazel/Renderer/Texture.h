@@ -0,0 +1,49 @@
+#pragma once
+#include <Hazel/Core/Base.h>
+#include <Support/HeadlessGL.h>
+#include <cstdint>
+
+//The engine's Texture2D on the headless GL context, RGBA8 only
+namespace Hazel
+{
+	class Texture2D
+	{
+		public:
+			Texture2D(uint32_t width, uint32_t height)
+				: Width(width), Height(height)
+			{
+				glGenTextures(1, &RendererID);
+				glBindTexture(GL_TEXTURE_2D, RendererID);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			}
+
+			~Texture2D() { glDeleteTextures(1, &RendererID); }
+
+			static Ref<Texture2D> Create(uint32_t width, uint32_t height) { return CreateRef<Texture2D>(width, height); }
+
+			uint32_t GetWidth() const { return Width; }
+			uint32_t GetHeight() const { return Height; }
+			uint32_t GetRendererID() const { return RendererID; }
+
+			void SetData(void* data, uint32_t size)
+			{
+				glBindTexture(GL_TEXTURE_2D, RendererID);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+			}
+
+			void Bind(uint32_t slot = 0) const
+			{
+				glActiveTexture(GL_TEXTURE0 + slot);
+				glBindTexture(GL_TEXTURE_2D, RendererID);
+			}
+
+			bool operator==(const Texture2D& other) const { return RendererID == other.RendererID; }
+
+		private:
+			uint32_t Width;
+			uint32_t Height;
+			GLuint RendererID = 0;
+	};
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <Hazel/Renderer/Buffer.h>
+#include <vector>
+
+//The engine's VertexArray on the headless GL context
+namespace Hazel
+{
+	class VertexArray
+	{
+		public:
+			VertexArray() { glGenVertexArrays(1, &RendererID); }
+			~VertexArray() { glDeleteVertexArrays(1, &RendererID); }
+
+			static Ref<VertexArray> Create() { return CreateRef<VertexArray>(); }
+
+			void Bind() const { glBindVertexArray(RendererID); }
+
+			void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
+			{
+				glBindVertexArray(RendererID);
+				vertexBuffer->Bind();
+				const BufferLayout& layout = vertexBuffer->GetLayout();
+				for (auto& element : layout.GetElements())
+				{
+					bool integer = element.Type >= ShaderDataType::Int;
+					glEnableVertexAttribArray(AttributeIndex);
+					if (integer)
+					{
+						glVertexAttribIPointer(AttributeIndex, element.GetComponentCount(), GL_INT,
+							layout.GetStride(), (const void*)element.Offset);
+					}
+					else
+					{
+						glVertexAttribPointer(AttributeIndex, element.GetComponentCount(), GL_FLOAT,
+							element.Normalized ? GL_TRUE : GL_FALSE, layout.GetStride(), (const void*)element.Offset);
+					}
+					AttributeIndex++;
+				}
+				VertexBuffers.push_back(vertexBuffer);
+			}
+
+			void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
+			{
+				glBindVertexArray(RendererID);
+				indexBuffer->Bind();
+				Indices = indexBuffer;
+			}
+
+			const Ref<IndexBuffer>& GetIndexBuffer() const { return Indices; }
+
+		private:
+			GLuint RendererID = 0;
+			GLuint AttributeIndex = 0;
+			std::vector<Ref<VertexBuffer>> VertexBuffers;
+			Ref<IndexBuffer> Indices;
+	};
+}